@@ -0,0 +1,3 @@
+#pragma once
+
+// Color definitions are part of pebble.h in the host shim
\ No newline at end of file
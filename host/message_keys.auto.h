@@ -0,0 +1,12 @@
+#pragma once
+
+#include <stdint.h>
+
+// Normally generated by the SDK from the messageKeys in package.json
+extern uint32_t MESSAGE_KEY_Settings;
+extern uint32_t MESSAGE_KEY_UploadId;
+extern uint32_t MESSAGE_KEY_UploadLength;
+extern uint32_t MESSAGE_KEY_UploadName;
+extern uint32_t MESSAGE_KEY_UploadOffset;
+extern uint32_t MESSAGE_KEY_UploadData;
+extern uint32_t MESSAGE_KEY_UploadAck;
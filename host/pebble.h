@@ -0,0 +1,486 @@
+#pragma once
+
+// Minimal stand-in for the Pebble SDK header, only what the app uses.
+// Implemented by pebble_shim.c on top of a virtual clock, see pebble_sim.h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "resource_ids.auto.h"
+#include "message_keys.auto.h"
+
+#define ARRAY_LENGTH(array) (sizeof((array))/sizeof((array)[0]))
+
+#define PBL_PLATFORM_BASALT
+#define PBL_COLOR
+#define PBL_RECT
+#define PBL_DISPLAY_WIDTH (144)
+#define PBL_DISPLAY_HEIGHT (168)
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+#define PBL_IF_BW_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_RECT_ELSE(if_true, if_false) (if_true)
+#define PBL_API_EXISTS(api) (1)
+
+// Logging
+
+typedef enum {
+    APP_LOG_LEVEL_ERROR = 1,
+    APP_LOG_LEVEL_WARNING = 50,
+    APP_LOG_LEVEL_INFO = 100,
+    APP_LOG_LEVEL_DEBUG = 200,
+    APP_LOG_LEVEL_DEBUG_VERBOSE = 255,
+} AppLogLevel;
+
+void app_log(uint8_t log_level, const char* src_filename, int src_line_number, const char* fmt, ...);
+#define APP_LOG(level, fmt, args...) app_log(level, __FILE__, __LINE__, fmt, ## args)
+
+// Time
+
+#define time(tloc) sim_time(tloc)
+time_t sim_time(time_t* tloc);
+uint16_t time_ms(time_t* tloc, uint16_t* out_ms);
+
+typedef enum {
+    SECOND_UNIT = 1 << 0,
+    MINUTE_UNIT = 1 << 1,
+    HOUR_UNIT = 1 << 2,
+    DAY_UNIT = 1 << 3,
+} TimeUnits;
+
+typedef void (*TickHandler)(struct tm* tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void* data);
+AppTimer* app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void* callback_data);
+bool app_timer_reschedule(AppTimer* timer_handle, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer* timer_handle);
+
+// Math
+
+#define TRIG_MAX_RATIO (0xffff)
+#define TRIG_MAX_ANGLE (0x10000)
+#define DEG_TO_TRIGANGLE(angle) (((angle) * TRIG_MAX_ANGLE) / 360)
+#define TRIGANGLE_TO_DEG(trig_angle) (((trig_angle) * 360) / TRIG_MAX_ANGLE)
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+
+// Graphics types
+
+typedef union GColor8 {
+    uint8_t argb;
+} GColor8;
+typedef GColor8 GColor;
+
+#define GColorBlack ((GColor8){.argb = 0xC0})
+#define GColorWhite ((GColor8){.argb = 0xFF})
+#define GColorClear ((GColor8){.argb = 0x00})
+#define GColorLightGray ((GColor8){.argb = 0xEA})
+#define GColorDarkGray ((GColor8){.argb = 0xD5})
+bool gcolor_equal(GColor8 x, GColor8 y);
+
+typedef struct GPoint {
+    int16_t x;
+    int16_t y;
+} GPoint;
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GPointZero GPoint(0, 0)
+
+typedef struct GSize {
+    int16_t w;
+    int16_t h;
+} GSize;
+#define GSize(w, h) ((GSize){(w), (h)})
+
+typedef struct GRect {
+    GPoint origin;
+    GSize size;
+} GRect;
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GRectZero GRect(0, 0, 0, 0)
+bool grect_equal(const GRect* const rect_a, const GRect* const rect_b);
+
+typedef enum {
+    GBitmapFormat1Bit = 0,
+    GBitmapFormat8Bit,
+    GBitmapFormat1BitPalette,
+    GBitmapFormat2BitPalette,
+    GBitmapFormat4BitPalette,
+    GBitmapFormat8BitCircular,
+} GBitmapFormat;
+
+typedef struct GBitmap GBitmap;
+typedef struct {
+    uint8_t* data;
+    int16_t min_x;
+    int16_t max_x;
+} GBitmapDataRowInfo;
+
+GBitmap* gbitmap_create_with_resource(uint32_t resource_id);
+void gbitmap_destroy(GBitmap* bitmap);
+GBitmapFormat gbitmap_get_format(const GBitmap* bitmap);
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap* bitmap, uint16_t y);
+GRect gbitmap_get_bounds(const GBitmap* bitmap);
+GColor* gbitmap_get_palette(const GBitmap* bitmap);
+void gbitmap_set_palette(GBitmap* bitmap, GColor* palette, bool free_on_destroy);
+
+typedef struct GContext GContext;
+typedef struct GFont* GFont;
+typedef struct GTextAttributes GTextAttributes;
+
+typedef enum {
+    GTextOverflowModeWordWrap,
+    GTextOverflowModeTrailingEllipsis,
+    GTextOverflowModeFill,
+} GTextOverflowMode;
+
+typedef enum {
+    GTextAlignmentLeft,
+    GTextAlignmentCenter,
+    GTextAlignmentRight,
+} GTextAlignment;
+
+typedef enum {
+    GOvalScaleModeFitCircle,
+    GOvalScaleModeFillCircle,
+} GOvalScaleMode;
+
+typedef enum {
+    GCornerNone = 0,
+    GCornersAll = 0x0F,
+} GCornerMask;
+
+#define FONT_KEY_GOTHIC_14 "RESOURCE_ID_GOTHIC_14"
+#define FONT_KEY_GOTHIC_18 "RESOURCE_ID_GOTHIC_18"
+#define FONT_KEY_GOTHIC_18_BOLD "RESOURCE_ID_GOTHIC_18_BOLD"
+#define FONT_KEY_GOTHIC_24 "RESOURCE_ID_GOTHIC_24"
+#define FONT_KEY_GOTHIC_24_BOLD "RESOURCE_ID_GOTHIC_24_BOLD"
+#define FONT_KEY_GOTHIC_28_BOLD "RESOURCE_ID_GOTHIC_28_BOLD"
+GFont fonts_get_system_font(const char* font_key);
+
+void graphics_context_set_fill_color(GContext* ctx, GColor color);
+void graphics_context_set_stroke_color(GContext* ctx, GColor color);
+void graphics_context_set_text_color(GContext* ctx, GColor color);
+void graphics_context_set_antialiased(GContext* ctx, bool enable);
+void graphics_fill_rect(GContext* ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void graphics_fill_circle(GContext* ctx, GPoint p, uint16_t radius);
+void graphics_fill_radial(GContext* ctx, GRect rect, GOvalScaleMode scale_mode, uint16_t inset_thickness, int32_t angle_start, int32_t angle_end);
+void graphics_draw_text(GContext* ctx, const char* text, GFont const font, const GRect box, const GTextOverflowMode overflow_mode, const GTextAlignment alignment, GTextAttributes* text_attributes);
+GBitmap* graphics_capture_frame_buffer(GContext* ctx);
+bool graphics_release_frame_buffer(GContext* ctx, GBitmap* buffer);
+
+// Layers and windows
+
+typedef struct Layer Layer;
+typedef void (*LayerUpdateProc)(struct Layer* layer, GContext* ctx);
+Layer* layer_create(GRect frame);
+void layer_destroy(Layer* layer);
+void layer_mark_dirty(Layer* layer);
+void layer_set_update_proc(Layer* layer, LayerUpdateProc update_proc);
+void layer_add_child(Layer* parent, Layer* child);
+void layer_remove_from_parent(Layer* child);
+GRect layer_get_bounds(const Layer* layer);
+GRect layer_get_frame(const Layer* layer);
+void layer_set_frame(Layer* layer, GRect frame);
+void layer_set_hidden(Layer* layer, bool hidden);
+GRect layer_get_unobstructed_bounds(const Layer* layer);
+
+typedef enum {
+    BUTTON_ID_BACK = 0,
+    BUTTON_ID_UP,
+    BUTTON_ID_SELECT,
+    BUTTON_ID_DOWN,
+    NUM_BUTTONS,
+} ButtonId;
+
+typedef void* ClickRecognizerRef;
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void* context);
+typedef void (*ClickConfigProvider)(void* context);
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler);
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler, ClickHandler up_handler);
+
+typedef struct Window Window;
+typedef void (*WindowHandler)(Window* window);
+typedef struct {
+    WindowHandler load;
+    WindowHandler appear;
+    WindowHandler disappear;
+    WindowHandler unload;
+} WindowHandlers;
+
+Window* window_create(void);
+void window_destroy(Window* window);
+void window_set_window_handlers(Window* window, WindowHandlers handlers);
+void window_set_background_color(Window* window, GColor background_color);
+void window_set_click_config_provider(Window* window, ClickConfigProvider click_config_provider);
+Layer* window_get_root_layer(const Window* window);
+void window_stack_push(Window* window, bool animated);
+bool window_stack_remove(Window* window, bool animated);
+Window* window_stack_pop(bool animated);
+Window* window_stack_get_top_window(void);
+bool window_stack_contains_window(Window* window);
+
+typedef struct TextLayer TextLayer;
+TextLayer* text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer* text_layer);
+Layer* text_layer_get_layer(TextLayer* text_layer);
+void text_layer_set_text(TextLayer* text_layer, const char* text);
+const char* text_layer_get_text(TextLayer* text_layer);
+void text_layer_set_font(TextLayer* text_layer, GFont font);
+void text_layer_set_text_alignment(TextLayer* text_layer, GTextAlignment text_alignment);
+void text_layer_set_background_color(TextLayer* text_layer, GColor color);
+void text_layer_set_text_color(TextLayer* text_layer, GColor color);
+
+#define STATUS_BAR_LAYER_HEIGHT (16)
+typedef enum {
+    StatusBarLayerSeparatorModeNone,
+    StatusBarLayerSeparatorModeDotted,
+} StatusBarLayerSeparatorMode;
+
+typedef struct StatusBarLayer StatusBarLayer;
+StatusBarLayer* status_bar_layer_create(void);
+void status_bar_layer_destroy(StatusBarLayer* status_bar_layer);
+Layer* status_bar_layer_get_layer(StatusBarLayer* status_bar_layer);
+void status_bar_layer_set_colors(StatusBarLayer* status_bar_layer, GColor background, GColor foreground);
+void status_bar_layer_set_separator_mode(StatusBarLayer* status_bar_layer, StatusBarLayerSeparatorMode mode);
+
+#define ACTION_BAR_WIDTH (30)
+typedef struct ActionBarLayer ActionBarLayer;
+ActionBarLayer* action_bar_layer_create(void);
+void action_bar_layer_destroy(ActionBarLayer* action_bar_layer);
+Layer* action_bar_layer_get_layer(ActionBarLayer* action_bar_layer);
+void action_bar_layer_set_background_color(ActionBarLayer* action_bar_layer, GColor background_color);
+void action_bar_layer_add_to_window(ActionBarLayer* action_bar_layer, Window* window);
+void action_bar_layer_remove_from_window(ActionBarLayer* action_bar_layer);
+void action_bar_layer_set_click_config_provider(ActionBarLayer* action_bar, ClickConfigProvider click_config_provider);
+void action_bar_layer_set_icon_animated(ActionBarLayer* action_bar, ButtonId button_id, const GBitmap* icon, bool animated);
+
+#define MENU_CELL_BASIC_HEADER_HEIGHT (16)
+typedef struct MenuLayer MenuLayer;
+typedef struct {
+    uint16_t section;
+    uint16_t row;
+} MenuIndex;
+typedef struct {
+    uint16_t (*get_num_sections)(MenuLayer* menu_layer, void* callback_context);
+    uint16_t (*get_num_rows)(MenuLayer* menu_layer, uint16_t section_index, void* callback_context);
+    int16_t (*get_cell_height)(MenuLayer* menu_layer, MenuIndex* cell_index, void* callback_context);
+    int16_t (*get_header_height)(MenuLayer* menu_layer, uint16_t section_index, void* callback_context);
+    void (*draw_row)(GContext* ctx, const Layer* cell_layer, MenuIndex* cell_index, void* callback_context);
+    void (*draw_header)(GContext* ctx, const Layer* cell_layer, uint16_t section_index, void* callback_context);
+    void (*select_click)(MenuLayer* menu_layer, MenuIndex* cell_index, void* callback_context);
+} MenuLayerCallbacks;
+MenuLayer* menu_layer_create(GRect frame);
+void menu_layer_destroy(MenuLayer* menu_layer);
+Layer* menu_layer_get_layer(const MenuLayer* menu_layer);
+void menu_layer_set_callbacks(MenuLayer* menu_layer, void* callback_context, MenuLayerCallbacks callbacks);
+void menu_layer_set_click_config_onto_window(MenuLayer* menu_layer, Window* window);
+void menu_layer_set_normal_colors(MenuLayer* menu_layer, GColor background, GColor foreground);
+void menu_layer_set_highlight_colors(MenuLayer* menu_layer, GColor background, GColor foreground);
+void menu_cell_basic_draw(GContext* ctx, const Layer* cell_layer, const char* title, const char* subtitle, GBitmap* icon);
+void menu_cell_basic_header_draw(GContext* ctx, const Layer* cell_layer, const char* title);
+
+// Platform services
+
+typedef struct {
+    const uint32_t* durations;
+    uint32_t num_segments;
+} VibePattern;
+void vibes_enqueue_custom_pattern(VibePattern pattern);
+void vibes_short_pulse(void);
+void vibes_long_pulse(void);
+void vibes_double_pulse(void);
+void vibes_cancel(void);
+
+void light_enable(bool enable);
+void light_enable_interaction(void);
+
+typedef enum {
+    APP_EXIT_NOT_SPECIFIED = 0,
+    APP_EXIT_USER_REQUESTED_EXIT,
+    APP_EXIT_ACTION_PERFORMED_SUCCESSFULLY,
+} AppExitReason;
+void exit_reason_set(AppExitReason reason);
+
+#define PERSIST_DATA_MAX_LENGTH (256)
+bool persist_exists(const uint32_t key);
+int persist_get_size(const uint32_t key);
+int persist_read_data(const uint32_t key, void* buffer, const size_t buffer_size);
+int persist_write_data(const uint32_t key, const void* data, const size_t size);
+int32_t persist_read_int(const uint32_t key);
+int persist_write_int(const uint32_t key, const int32_t value);
+int persist_delete(const uint32_t key);
+
+typedef const void* ResHandle;
+ResHandle resource_get_handle(uint32_t resource_id);
+size_t resource_size(ResHandle h);
+size_t resource_load_byte_range(ResHandle h, uint32_t start_offset, uint8_t* buffer, size_t num_bytes);
+
+typedef struct {
+    uint8_t charge_percent;
+    bool is_charging;
+    bool is_plugged;
+} BatteryChargeState;
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+BatteryChargeState battery_state_service_peek(void);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
+
+typedef enum {
+    APP_WORKER_RESULT_SUCCESS = 0,
+    APP_WORKER_RESULT_NO_WORKER = 1,
+    APP_WORKER_RESULT_DIFFERENT_APP = 2,
+    APP_WORKER_RESULT_NOT_RUNNING = 3,
+    APP_WORKER_RESULT_ALREADY_RUNNING = 4,
+    APP_WORKER_RESULT_ASKING_CONFIRMATION = 5,
+} AppWorkerResult;
+typedef struct {
+    uint16_t data0;
+    uint16_t data1;
+    uint16_t data2;
+} AppWorkerMessage;
+typedef void (*AppWorkerMessageHandler)(uint16_t type, AppWorkerMessage* data);
+bool app_worker_is_running(void);
+AppWorkerResult app_worker_launch(void);
+AppWorkerResult app_worker_kill(void);
+bool app_worker_message_subscribe(AppWorkerMessageHandler handler);
+bool app_worker_message_unsubscribe(void);
+void app_worker_send_message(uint8_t type, AppWorkerMessage* data);
+
+typedef enum {
+    TUPLE_BYTE_ARRAY = 0,
+    TUPLE_CSTRING = 1,
+    TUPLE_UINT = 2,
+    TUPLE_INT = 3,
+} TupleType;
+// The real tuple is packed with a flexible value, the stand-in only
+// carries integers and short byte arrays
+typedef struct {
+    uint32_t key;
+    TupleType type;
+    uint16_t length;
+    union {
+        uint8_t data[64];
+        char cstring[64];
+        uint8_t uint8;
+        uint16_t uint16;
+        uint32_t uint32;
+        int8_t int8;
+        int16_t int16;
+        int32_t int32;
+    } value[1];
+} Tuple;
+typedef struct {
+    Tuple* tuples;
+    uint16_t count;
+    uint16_t capacity;
+    uint16_t cursor;
+} DictionaryIterator;
+typedef enum {
+    DICT_OK = 0,
+    DICT_NOT_ENOUGH_STORAGE = 1 << 1,
+    DICT_INVALID_ARGS = 1 << 2,
+} DictionaryResult;
+Tuple* dict_read_first(DictionaryIterator* iter);
+Tuple* dict_read_next(DictionaryIterator* iter);
+Tuple* dict_find(const DictionaryIterator* iter, const uint32_t key);
+DictionaryResult dict_write_int32(DictionaryIterator* iter, const uint32_t key, const int32_t value);
+DictionaryResult dict_write_uint8(DictionaryIterator* iter, const uint32_t key, const uint8_t value);
+DictionaryResult dict_write_data(DictionaryIterator* iter, const uint32_t key, const uint8_t* data, const uint16_t size);
+
+typedef enum {
+    APP_MSG_OK = 0,
+    APP_MSG_SEND_TIMEOUT = 1 << 1,
+    APP_MSG_SEND_REJECTED = 1 << 2,
+    APP_MSG_NOT_CONNECTED = 1 << 3,
+    APP_MSG_APP_NOT_RUNNING = 1 << 4,
+    APP_MSG_INVALID_ARGS = 1 << 5,
+    APP_MSG_BUSY = 1 << 6,
+    APP_MSG_BUFFER_OVERFLOW = 1 << 7,
+    APP_MSG_ALREADY_RELEASED = 1 << 9,
+    APP_MSG_CALLBACK_ALREADY_REGISTERED = 1 << 10,
+    APP_MSG_CALLBACK_NOT_REGISTERED = 1 << 11,
+    APP_MSG_OUT_OF_MEMORY = 1 << 12,
+    APP_MSG_CLOSED = 1 << 13,
+    APP_MSG_INTERNAL_ERROR = 1 << 14,
+} AppMessageResult;
+typedef void (*AppMessageInboxReceived)(DictionaryIterator* iterator, void* context);
+typedef void (*AppMessageInboxDropped)(AppMessageResult reason, void* context);
+typedef void (*AppMessageOutboxSent)(DictionaryIterator* iterator, void* context);
+typedef void (*AppMessageOutboxFailed)(DictionaryIterator* iterator, AppMessageResult reason, void* context);
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound);
+void app_message_deregister_callbacks(void);
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback);
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback);
+AppMessageOutboxSent app_message_register_outbox_sent(AppMessageOutboxSent sent_callback);
+AppMessageOutboxFailed app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback);
+AppMessageResult app_message_outbox_begin(DictionaryIterator** iterator);
+AppMessageResult app_message_outbox_send(void);
+
+typedef enum {
+    APP_LAUNCH_SYSTEM = 0,
+    APP_LAUNCH_USER = 1,
+    APP_LAUNCH_PHONE = 2,
+    APP_LAUNCH_WAKEUP = 3,
+    APP_LAUNCH_WORKER = 4,
+    APP_LAUNCH_QUICK_LAUNCH = 5,
+    APP_LAUNCH_TIMELINE_ACTION = 6,
+    APP_LAUNCH_SMARTSTRAP = 7,
+} AppLaunchReason;
+AppLaunchReason launch_reason(void);
+
+typedef enum {
+    S_SUCCESS = 0,
+    E_ERROR = -1,
+    E_UNKNOWN = -2,
+    E_INTERNAL = -3,
+    E_INVALID_ARGUMENT = -4,
+    E_OUT_OF_MEMORY = -5,
+    E_OUT_OF_STORAGE = -6,
+    E_OUT_OF_RESOURCES = -7,
+    E_RANGE = -8,
+} StatusCode;
+typedef int32_t WakeupId;
+typedef void (*WakeupHandler)(WakeupId wakeup_id, int32_t cookie);
+WakeupId wakeup_schedule(time_t timestamp, int32_t cookie, bool notify_if_missed);
+void wakeup_cancel(WakeupId wakeup_id);
+void wakeup_cancel_all(void);
+bool wakeup_query(WakeupId wakeup_id, time_t* timestamp);
+void wakeup_service_subscribe(WakeupHandler handler);
+
+typedef uint32_t AnimationProgress;
+typedef struct {
+    void (*will_change)(GRect final_unobstructed_screen_area, void* context);
+    void (*change)(AnimationProgress progress, void* context);
+    void (*did_change)(void* context);
+} UnobstructedAreaHandlers;
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void* context);
+void unobstructed_area_service_unsubscribe(void);
+
+size_t heap_bytes_used(void);
+size_t heap_bytes_free(void);
+
+typedef struct AppGlanceReloadSession AppGlanceReloadSession;
+typedef struct {
+    struct {
+        uint32_t icon;
+        const char* subtitle_template_string;
+    } layout;
+    time_t expiration_time;
+} AppGlanceSlice;
+typedef enum {
+    APP_GLANCE_RESULT_SUCCESS = 0,
+} AppGlanceResult;
+#define APP_GLANCE_SLICE_NO_EXPIRATION ((time_t)0)
+typedef void (*AppGlanceReloadCallback)(AppGlanceReloadSession* session, size_t limit, void* context);
+AppGlanceResult app_glance_add_slice(AppGlanceReloadSession* session, AppGlanceSlice slice);
+void app_glance_reload(AppGlanceReloadCallback callback, void* context);
+
+void app_event_loop(void);
\ No newline at end of file
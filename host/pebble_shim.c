@@ -0,0 +1,1819 @@
+#include "pebble_sim.h"
+
+#include <math.h>
+#include <stdarg.h>
+
+#define SCREEN_WIDTH (PBL_DISPLAY_WIDTH)
+#define SCREEN_HEIGHT (PBL_DISPLAY_HEIGHT)
+#define MAX_TIMERS (16)
+#define MAX_PERSIST_KEYS (64)
+#define MAX_WINDOWS (8)
+#define START_TIME_S (1700000000)
+#define MAX_WAKEUPS (8)
+#define WAKEUP_SPACING_S (60)
+// Roughly how long the system takes to slide a pushed window in
+#define PUSH_ANIMATION_MS (250)
+#define MAX_DICT_TUPLES (32)
+// Tuple header bytes in the real dictionary layout
+#define TUPLE_HEADER_SIZE (7)
+// Roughly what an aplite app has left for its heap
+#define SIM_HEAP_SIZE (24 * 1024)
+
+static SimStats m_stats;
+// Stand-in for the app heap, what the shim creates for the app counts
+// against it so heap_bytes_used moves like it does on the watch
+static size_t m_heap_used = 0;
+static bool m_verbose = false;
+static const char* m_resource_dir = "resources";
+static uint64_t m_now_ms = (uint64_t)START_TIME_S * 1000;
+static bool m_light_on = false;
+static bool m_render_pending = false;
+static uint64_t m_render_not_before_ms = 0;
+static AppLaunchReason m_launch_reason = APP_LAUNCH_USER;
+static uint64_t m_launch_ms = 0;
+static uint32_t m_launch_resource_reads = 0;
+static bool m_first_frame_pending = false;
+
+// Logging
+
+void sim_set_verbose(bool verbose)
+{
+    m_verbose = verbose;
+}
+
+void app_log(uint8_t log_level, const char* src_filename, int src_line_number, const char* fmt, ...)
+{
+    m_stats.log_lines++;
+    if(m_verbose)
+    {
+        va_list args;
+        va_start(args, fmt);
+        fprintf(stderr, "[%llu] %s:%d ", (unsigned long long)(m_now_ms % 100000), src_filename, src_line_number);
+        vfprintf(stderr, fmt, args);
+        fprintf(stderr, "\n");
+        va_end(args);
+    }
+}
+
+// Virtual clock and timers
+
+struct AppTimer {
+    bool active;
+    uint64_t fire_ms;
+    AppTimerCallback callback;
+    void* data;
+};
+
+static AppTimer m_timers[MAX_TIMERS];
+static TickHandler m_tick_handler = NULL;
+static TimeUnits m_tick_units;
+
+uint64_t sim_now_ms()
+{
+    return m_now_ms;
+}
+
+time_t sim_time(time_t* tloc)
+{
+    time_t now = m_now_ms / 1000;
+    if(tloc != NULL)
+    {
+        *tloc = now;
+    }
+    return now;
+}
+
+uint16_t time_ms(time_t* tloc, uint16_t* out_ms)
+{
+    uint16_t ms = m_now_ms % 1000;
+    sim_time(tloc);
+    if(out_ms != NULL)
+    {
+        *out_ms = ms;
+    }
+    return ms;
+}
+
+AppTimer* app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void* callback_data)
+{
+    for(int i = 0; i < MAX_TIMERS; i++)
+    {
+        if(!m_timers[i].active)
+        {
+            m_timers[i] = (AppTimer) {
+                .active = true,
+                .fire_ms = m_now_ms + timeout_ms,
+                .callback = callback,
+                .data = callback_data,
+            };
+            return &m_timers[i];
+        }
+    }
+    fprintf(stderr, "sim: out of timers\n");
+    abort();
+}
+
+bool app_timer_reschedule(AppTimer* timer_handle, uint32_t new_timeout_ms)
+{
+    if(timer_handle == NULL || !timer_handle->active)
+    {
+        return false;
+    }
+    timer_handle->fire_ms = m_now_ms + new_timeout_ms;
+    return true;
+}
+
+void app_timer_cancel(AppTimer* timer_handle)
+{
+    if(timer_handle != NULL)
+    {
+        timer_handle->active = false;
+    }
+}
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler)
+{
+    m_tick_units = tick_units;
+    m_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void)
+{
+    m_tick_handler = NULL;
+}
+
+bool sim_has_pending_timers()
+{
+    for(int i = 0; i < MAX_TIMERS; i++)
+    {
+        if(m_timers[i].active)
+        {
+            return true;
+        }
+    }
+    return m_tick_handler != NULL;
+}
+
+// Math
+
+int32_t sin_lookup(int32_t angle)
+{
+    return (int32_t)lround(sin(angle * 2 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle)
+{
+    return (int32_t)lround(cos(angle * 2 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+// Bitmaps and the frame buffer
+
+struct GBitmap {
+    GBitmapFormat format;
+    GRect bounds;
+    uint8_t* data;
+    GColor* palette;
+    bool free_palette;
+};
+
+static uint8_t m_frame_buffer_data[SCREEN_WIDTH * SCREEN_HEIGHT];
+static uint8_t m_frame_buffer_snapshot[SCREEN_WIDTH * SCREEN_HEIGHT];
+static GBitmap m_frame_buffer = {
+    .format = GBitmapFormat8Bit,
+    .bounds = {{0, 0}, {SCREEN_WIDTH, SCREEN_HEIGHT}},
+    .data = m_frame_buffer_data,
+};
+
+bool gcolor_equal(GColor8 x, GColor8 y)
+{
+    return x.argb == y.argb;
+}
+
+bool grect_equal(const GRect* const rect_a, const GRect* const rect_b)
+{
+    return memcmp(rect_a, rect_b, sizeof(GRect)) == 0;
+}
+
+typedef union {
+    size_t size;
+    long double align;
+    void* pointer;
+} HeapBlockHeader;
+
+static void* heap_calloc(size_t count, size_t size)
+{
+    HeapBlockHeader* header = calloc(1, sizeof(HeapBlockHeader) + count * size);
+    header->size = count * size;
+    m_heap_used += header->size;
+    return header + 1;
+}
+
+static void heap_free(void* pointer)
+{
+    if(pointer == NULL)
+    {
+        return;
+    }
+    HeapBlockHeader* header = (HeapBlockHeader*)pointer - 1;
+    m_heap_used -= header->size;
+    free(header);
+}
+
+GBitmap* gbitmap_create_with_resource(uint32_t resource_id)
+{
+    GBitmap* bitmap = heap_calloc(1, sizeof(GBitmap));
+    bitmap->format = GBitmapFormat2BitPalette;
+    bitmap->bounds = GRect(0, 0, 16, 16);
+    bitmap->palette = heap_calloc(4, sizeof(GColor));
+    bitmap->free_palette = true;
+    m_stats.live_bitmaps++;
+    m_stats.resource_reads++;
+    return bitmap;
+}
+
+void gbitmap_destroy(GBitmap* bitmap)
+{
+    if(bitmap == NULL)
+    {
+        return;
+    }
+    if(bitmap->free_palette)
+    {
+        heap_free(bitmap->palette);
+    }
+    heap_free(bitmap);
+    m_stats.live_bitmaps--;
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap* bitmap)
+{
+    return bitmap->format;
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap* bitmap, uint16_t y)
+{
+    return (GBitmapDataRowInfo) {
+        .data = bitmap->data + (size_t)y * bitmap->bounds.size.w,
+        .min_x = 0,
+        .max_x = bitmap->bounds.size.w - 1,
+    };
+}
+
+GRect gbitmap_get_bounds(const GBitmap* bitmap)
+{
+    return bitmap->bounds;
+}
+
+GColor* gbitmap_get_palette(const GBitmap* bitmap)
+{
+    return bitmap->palette;
+}
+
+void gbitmap_set_palette(GBitmap* bitmap, GColor* palette, bool free_on_destroy)
+{
+    if(bitmap->free_palette && bitmap->palette != palette)
+    {
+        heap_free(bitmap->palette);
+    }
+    // Setting the bitmap's own palette again keeps it owned by the bitmap
+    bitmap->free_palette = free_on_destroy || (bitmap->free_palette && bitmap->palette == palette);
+    bitmap->palette = palette;
+}
+
+// Graphics context, draws into the frame buffer in screen coordinates
+
+struct GContext {
+    GPoint offset;
+    GRect clip;
+    GColor fill_color;
+    GColor text_color;
+};
+
+static struct GFont {
+    int unused;
+} m_font;
+
+GFont fonts_get_system_font(const char* font_key)
+{
+    return &m_font;
+}
+
+void graphics_context_set_fill_color(GContext* ctx, GColor color)
+{
+    ctx->fill_color = color;
+}
+
+void graphics_context_set_stroke_color(GContext* ctx, GColor color)
+{
+}
+
+void graphics_context_set_text_color(GContext* ctx, GColor color)
+{
+    ctx->text_color = color;
+}
+
+void graphics_context_set_antialiased(GContext* ctx, bool enable)
+{
+}
+
+static void put_pixel(GContext* ctx, int x, int y, GColor color)
+{
+    x += ctx->offset.x;
+    y += ctx->offset.y;
+    if(x < ctx->clip.origin.x || x >= ctx->clip.origin.x + ctx->clip.size.w ||
+        y < ctx->clip.origin.y || y >= ctx->clip.origin.y + ctx->clip.size.h)
+    {
+        return;
+    }
+    if(color.argb != GColorClear.argb)
+    {
+        m_frame_buffer_data[y * SCREEN_WIDTH + x] = color.argb;
+    }
+}
+
+void graphics_fill_rect(GContext* ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask)
+{
+    m_stats.fill_rect_calls++;
+    for(int y = rect.origin.y; y < rect.origin.y + rect.size.h; y++)
+    {
+        for(int x = rect.origin.x; x < rect.origin.x + rect.size.w; x++)
+        {
+            put_pixel(ctx, x, y, ctx->fill_color);
+        }
+    }
+}
+
+void graphics_fill_circle(GContext* ctx, GPoint p, uint16_t radius)
+{
+    m_stats.fill_circle_calls++;
+    int r = radius;
+    for(int dy = -r; dy <= r; dy++)
+    {
+        for(int dx = -r; dx <= r; dx++)
+        {
+            if(dx * dx + dy * dy <= r * r)
+            {
+                put_pixel(ctx, p.x + dx, p.y + dy, ctx->fill_color);
+            }
+        }
+    }
+}
+
+void graphics_fill_radial(GContext* ctx, GRect rect, GOvalScaleMode scale_mode, uint16_t inset_thickness, int32_t angle_start, int32_t angle_end)
+{
+    m_stats.fill_radial_calls++;
+    int r = rect.size.w / 2;
+    GPoint center = GPoint(rect.origin.x + r, rect.origin.y + r);
+    for(int dy = -r; dy <= r; dy++)
+    {
+        for(int dx = -r; dx <= r; dx++)
+        {
+            int distance_squared = dx * dx + dy * dy;
+            int inner = r - inset_thickness;
+            if(distance_squared > r * r || (inner > 0 && distance_squared < inner * inner))
+            {
+                continue;
+            }
+            double angle = atan2(dx, -dy);
+            if(angle < 0)
+            {
+                angle += 2 * M_PI;
+            }
+            int32_t trig_angle = (int32_t)(angle * TRIG_MAX_ANGLE / (2 * M_PI));
+            if(trig_angle >= angle_start && trig_angle <= angle_end)
+            {
+                put_pixel(ctx, center.x + dx, center.y + dy, ctx->fill_color);
+            }
+        }
+    }
+}
+
+void graphics_draw_text(GContext* ctx, const char* text, GFont const font, const GRect box, const GTextOverflowMode overflow_mode, const GTextAlignment alignment, GTextAttributes* text_attributes)
+{
+    m_stats.draw_text_calls++;
+}
+
+GBitmap* graphics_capture_frame_buffer(GContext* ctx)
+{
+    memcpy(m_frame_buffer_snapshot, m_frame_buffer_data, sizeof(m_frame_buffer_data));
+    return &m_frame_buffer;
+}
+
+bool graphics_release_frame_buffer(GContext* ctx, GBitmap* buffer)
+{
+    for(size_t i = 0; i < sizeof(m_frame_buffer_data); i++)
+    {
+        if(m_frame_buffer_data[i] != m_frame_buffer_snapshot[i])
+        {
+            m_stats.frame_buffer_bytes_changed++;
+        }
+    }
+    return true;
+}
+
+// Layers
+
+struct Layer {
+    GRect frame;
+    LayerUpdateProc update_proc;
+    Layer* parent;
+    Layer* first_child;
+    Layer* next_sibling;
+    bool hidden;
+};
+
+Layer* layer_create(GRect frame)
+{
+    Layer* layer = heap_calloc(1, sizeof(Layer));
+    layer->frame = frame;
+    m_stats.live_layers++;
+    return layer;
+}
+
+void layer_remove_from_parent(Layer* child)
+{
+    if(child->parent == NULL)
+    {
+        return;
+    }
+    Layer** link = &child->parent->first_child;
+    while(*link != NULL && *link != child)
+    {
+        link = &(*link)->next_sibling;
+    }
+    if(*link == child)
+    {
+        *link = child->next_sibling;
+    }
+    child->parent = NULL;
+    child->next_sibling = NULL;
+}
+
+void layer_destroy(Layer* layer)
+{
+    if(layer == NULL)
+    {
+        return;
+    }
+    layer_remove_from_parent(layer);
+    for(Layer* child = layer->first_child; child != NULL; child = child->next_sibling)
+    {
+        child->parent = NULL;
+    }
+    heap_free(layer);
+    m_stats.live_layers--;
+}
+
+void layer_mark_dirty(Layer* layer)
+{
+    m_render_pending = true;
+}
+
+void layer_set_update_proc(Layer* layer, LayerUpdateProc update_proc)
+{
+    layer->update_proc = update_proc;
+}
+
+void layer_add_child(Layer* parent, Layer* child)
+{
+    layer_remove_from_parent(child);
+    child->parent = parent;
+    Layer** link = &parent->first_child;
+    while(*link != NULL)
+    {
+        link = &(*link)->next_sibling;
+    }
+    *link = child;
+    m_render_pending = true;
+}
+
+GRect layer_get_bounds(const Layer* layer)
+{
+    return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+static int16_t m_obstructed_height = 0;
+
+// The shim only asks this of window root layers, whose frame is the screen
+GRect layer_get_unobstructed_bounds(const Layer* layer)
+{
+    GRect bounds = layer_get_bounds(layer);
+    int16_t unobstructed_height = SCREEN_HEIGHT - m_obstructed_height - layer->frame.origin.y;
+    if(bounds.size.h > unobstructed_height)
+    {
+        bounds.size.h = unobstructed_height > 0 ? unobstructed_height : 0;
+    }
+    return bounds;
+}
+
+GRect layer_get_frame(const Layer* layer)
+{
+    return layer->frame;
+}
+
+void layer_set_frame(Layer* layer, GRect frame)
+{
+    layer->frame = frame;
+    m_render_pending = true;
+}
+
+void layer_set_hidden(Layer* layer, bool hidden)
+{
+    layer->hidden = hidden;
+    m_render_pending = true;
+}
+
+static uint64_t get_host_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static void render_layer(Layer* layer, GPoint parent_offset, GRect parent_clip)
+{
+    if(layer->hidden)
+    {
+        return;
+    }
+
+    GPoint offset = GPoint(parent_offset.x + layer->frame.origin.x, parent_offset.y + layer->frame.origin.y);
+    GRect clip = GRect(offset.x, offset.y, layer->frame.size.w, layer->frame.size.h);
+    int16_t left = clip.origin.x > parent_clip.origin.x ? clip.origin.x : parent_clip.origin.x;
+    int16_t top = clip.origin.y > parent_clip.origin.y ? clip.origin.y : parent_clip.origin.y;
+    int16_t right = clip.origin.x + clip.size.w < parent_clip.origin.x + parent_clip.size.w ? clip.origin.x + clip.size.w : parent_clip.origin.x + parent_clip.size.w;
+    int16_t bottom = clip.origin.y + clip.size.h < parent_clip.origin.y + parent_clip.size.h ? clip.origin.y + clip.size.h : parent_clip.origin.y + parent_clip.size.h;
+    clip = GRect(left, top, right > left ? right - left : 0, bottom > top ? bottom - top : 0);
+
+    if(layer->update_proc != NULL)
+    {
+        GContext ctx = {
+            .offset = offset,
+            .clip = clip,
+            .fill_color = GColorBlack,
+            .text_color = GColorBlack,
+        };
+        uint64_t start_ns = get_host_ns();
+        layer->update_proc(layer, &ctx);
+        uint64_t duration_ns = get_host_ns() - start_ns;
+        m_stats.update_proc_calls++;
+        m_stats.update_proc_ns += duration_ns;
+        if(duration_ns > m_stats.max_update_proc_ns)
+        {
+            m_stats.max_update_proc_ns = duration_ns;
+        }
+    }
+
+    for(Layer* child = layer->first_child; child != NULL; child = child->next_sibling)
+    {
+        render_layer(child, offset, clip);
+    }
+}
+
+// Windows and clicks
+
+struct Window {
+    Layer* root_layer;
+    WindowHandlers handlers;
+    GColor background_color;
+    ClickConfigProvider click_config_provider;
+    void* click_context;
+    ClickHandler click_handlers[NUM_BUTTONS];
+    ClickHandler long_click_handlers[NUM_BUTTONS];
+    bool loaded;
+};
+
+static Window* m_window_stack[MAX_WINDOWS];
+static int m_window_count = 0;
+static Window* m_configuring_window = NULL;
+
+static void update_root_layer(Layer* layer, GContext* ctx)
+{
+    for(int i = 0; i < m_window_count; i++)
+    {
+        Window* window = m_window_stack[i];
+        if(window->root_layer == layer && !gcolor_equal(window->background_color, GColorClear))
+        {
+            graphics_context_set_fill_color(ctx, window->background_color);
+            graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
+        }
+    }
+}
+
+Window* window_create(void)
+{
+    Window* window = heap_calloc(1, sizeof(Window));
+    window->root_layer = layer_create(GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT));
+    window->background_color = GColorWhite;
+    layer_set_update_proc(window->root_layer, update_root_layer);
+    m_stats.live_windows++;
+    return window;
+}
+
+void window_destroy(Window* window)
+{
+    if(window == NULL)
+    {
+        return;
+    }
+    window_stack_remove(window, false);
+    layer_destroy(window->root_layer);
+    heap_free(window);
+    m_stats.live_windows--;
+}
+
+void window_set_window_handlers(Window* window, WindowHandlers handlers)
+{
+    window->handlers = handlers;
+}
+
+void window_set_background_color(Window* window, GColor background_color)
+{
+    window->background_color = background_color;
+    m_render_pending = true;
+}
+
+void window_set_click_config_provider(Window* window, ClickConfigProvider click_config_provider)
+{
+    window->click_config_provider = click_config_provider;
+}
+
+Layer* window_get_root_layer(const Window* window)
+{
+    return window->root_layer;
+}
+
+static Window* get_top_window()
+{
+    return m_window_count > 0 ? m_window_stack[m_window_count - 1] : NULL;
+}
+
+static void configure_clicks(Window* window)
+{
+    memset(window->click_handlers, 0, sizeof(window->click_handlers));
+    memset(window->long_click_handlers, 0, sizeof(window->long_click_handlers));
+    if(window->click_config_provider != NULL)
+    {
+        m_configuring_window = window;
+        window->click_config_provider(window->click_context);
+        m_configuring_window = NULL;
+    }
+}
+
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler)
+{
+    if(m_configuring_window != NULL)
+    {
+        m_configuring_window->click_handlers[button_id] = handler;
+    }
+}
+
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler, ClickHandler up_handler)
+{
+    if(m_configuring_window != NULL)
+    {
+        m_configuring_window->long_click_handlers[button_id] = down_handler != NULL ? down_handler : up_handler;
+    }
+}
+
+void window_stack_push(Window* window, bool animated)
+{
+    Window* previous = get_top_window();
+    if(previous != NULL && previous->handlers.disappear != NULL)
+    {
+        previous->handlers.disappear(previous);
+    }
+    m_window_stack[m_window_count++] = window;
+    if(animated)
+    {
+        m_render_not_before_ms = m_now_ms + PUSH_ANIMATION_MS;
+    }
+    if(!window->loaded)
+    {
+        window->loaded = true;
+        if(window->handlers.load != NULL)
+        {
+            window->handlers.load(window);
+        }
+    }
+    configure_clicks(window);
+    if(window->handlers.appear != NULL)
+    {
+        window->handlers.appear(window);
+    }
+    m_render_pending = true;
+}
+
+bool window_stack_remove(Window* window, bool animated)
+{
+    for(int i = 0; i < m_window_count; i++)
+    {
+        if(m_window_stack[i] != window)
+        {
+            continue;
+        }
+        bool was_top = i == m_window_count - 1;
+        memmove(&m_window_stack[i], &m_window_stack[i + 1], (m_window_count - i - 1) * sizeof(Window*));
+        m_window_count--;
+        if(was_top && window->handlers.disappear != NULL)
+        {
+            window->handlers.disappear(window);
+        }
+        if(window->handlers.unload != NULL)
+        {
+            window->handlers.unload(window);
+        }
+        window->loaded = false;
+        Window* top = get_top_window();
+        if(was_top && top != NULL && top->handlers.appear != NULL)
+        {
+            top->handlers.appear(top);
+        }
+        m_render_pending = true;
+        return true;
+    }
+    return false;
+}
+
+Window* window_stack_get_top_window(void)
+{
+    return get_top_window();
+}
+
+Window* window_stack_pop(bool animated)
+{
+    Window* top = get_top_window();
+    if(top != NULL)
+    {
+        window_stack_remove(top, animated);
+    }
+    return top;
+}
+
+bool window_stack_contains_window(Window* window)
+{
+    for(int i = 0; i < m_window_count; i++)
+    {
+        if(m_window_stack[i] == window)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void sim_click(ButtonId button_id)
+{
+    Window* window = get_top_window();
+    if(window == NULL)
+    {
+        return;
+    }
+    if(window->click_handlers[button_id] != NULL)
+    {
+        window->click_handlers[button_id](NULL, window->click_context);
+    } else if(button_id == BUTTON_ID_BACK)
+    {
+        window_stack_pop(true);
+    }
+    if(m_render_pending)
+    {
+        m_render_pending = false;
+        m_stats.renders++;
+        render_layer(window->root_layer, GPointZero, GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT));
+    }
+}
+
+void sim_long_click(ButtonId button_id)
+{
+    Window* window = get_top_window();
+    if(window == NULL || window->long_click_handlers[button_id] == NULL)
+    {
+        return;
+    }
+    window->long_click_handlers[button_id](NULL, window->click_context);
+    if(m_render_pending)
+    {
+        m_render_pending = false;
+        m_stats.renders++;
+        render_layer(window->root_layer, GPointZero, GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT));
+    }
+}
+
+// Text, status bar, action bar and menu layers are plain layers that
+// only record their state
+
+struct TextLayer {
+    Layer* layer;
+    const char* text;
+    GColor background_color;
+};
+
+static void update_text_layer(Layer* layer, GContext* ctx)
+{
+    m_stats.draw_text_calls++;
+}
+
+TextLayer* text_layer_create(GRect frame)
+{
+    TextLayer* text_layer = heap_calloc(1, sizeof(TextLayer));
+    text_layer->layer = layer_create(frame);
+    layer_set_update_proc(text_layer->layer, update_text_layer);
+    return text_layer;
+}
+
+void text_layer_destroy(TextLayer* text_layer)
+{
+    if(text_layer != NULL)
+    {
+        layer_destroy(text_layer->layer);
+        heap_free(text_layer);
+    }
+}
+
+Layer* text_layer_get_layer(TextLayer* text_layer)
+{
+    return text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer* text_layer, const char* text)
+{
+    text_layer->text = text;
+    m_render_pending = true;
+}
+
+const char* text_layer_get_text(TextLayer* text_layer)
+{
+    return text_layer->text;
+}
+
+void text_layer_set_font(TextLayer* text_layer, GFont font)
+{
+}
+
+void text_layer_set_text_alignment(TextLayer* text_layer, GTextAlignment text_alignment)
+{
+}
+
+void text_layer_set_background_color(TextLayer* text_layer, GColor color)
+{
+    text_layer->background_color = color;
+}
+
+void text_layer_set_text_color(TextLayer* text_layer, GColor color)
+{
+}
+
+struct StatusBarLayer {
+    Layer* layer;
+};
+
+StatusBarLayer* status_bar_layer_create(void)
+{
+    StatusBarLayer* status_bar = heap_calloc(1, sizeof(StatusBarLayer));
+    status_bar->layer = layer_create(GRect(0, 0, SCREEN_WIDTH, STATUS_BAR_LAYER_HEIGHT));
+    return status_bar;
+}
+
+void status_bar_layer_destroy(StatusBarLayer* status_bar_layer)
+{
+    if(status_bar_layer != NULL)
+    {
+        layer_destroy(status_bar_layer->layer);
+        heap_free(status_bar_layer);
+    }
+}
+
+Layer* status_bar_layer_get_layer(StatusBarLayer* status_bar_layer)
+{
+    return status_bar_layer->layer;
+}
+
+void status_bar_layer_set_colors(StatusBarLayer* status_bar_layer, GColor background, GColor foreground)
+{
+}
+
+void status_bar_layer_set_separator_mode(StatusBarLayer* status_bar_layer, StatusBarLayerSeparatorMode mode)
+{
+}
+
+struct ActionBarLayer {
+    Layer* layer;
+    Window* window;
+    ClickConfigProvider click_config_provider;
+};
+
+ActionBarLayer* action_bar_layer_create(void)
+{
+    ActionBarLayer* action_bar = heap_calloc(1, sizeof(ActionBarLayer));
+    action_bar->layer = layer_create(GRect(SCREEN_WIDTH - ACTION_BAR_WIDTH, 0, ACTION_BAR_WIDTH, SCREEN_HEIGHT));
+    return action_bar;
+}
+
+void action_bar_layer_destroy(ActionBarLayer* action_bar_layer)
+{
+    if(action_bar_layer != NULL)
+    {
+        layer_destroy(action_bar_layer->layer);
+        heap_free(action_bar_layer);
+    }
+}
+
+Layer* action_bar_layer_get_layer(ActionBarLayer* action_bar_layer)
+{
+    return action_bar_layer->layer;
+}
+
+void action_bar_layer_set_background_color(ActionBarLayer* action_bar_layer, GColor background_color)
+{
+}
+
+void action_bar_layer_add_to_window(ActionBarLayer* action_bar_layer, Window* window)
+{
+    action_bar_layer->window = window;
+    layer_add_child(window->root_layer, action_bar_layer->layer);
+    window->click_config_provider = action_bar_layer->click_config_provider;
+}
+
+void action_bar_layer_remove_from_window(ActionBarLayer* action_bar_layer)
+{
+    layer_remove_from_parent(action_bar_layer->layer);
+    action_bar_layer->window = NULL;
+}
+
+void action_bar_layer_set_click_config_provider(ActionBarLayer* action_bar, ClickConfigProvider click_config_provider)
+{
+    action_bar->click_config_provider = click_config_provider;
+    if(action_bar->window != NULL)
+    {
+        action_bar->window->click_config_provider = click_config_provider;
+    }
+}
+
+void action_bar_layer_set_icon_animated(ActionBarLayer* action_bar, ButtonId button_id, const GBitmap* icon, bool animated)
+{
+}
+
+// Menus draw every row into their own layer, up and down move the
+// selection and select clicks the selected row
+
+struct MenuLayer {
+    Layer* layer;
+    MenuLayerCallbacks callbacks;
+    void* callback_context;
+    MenuIndex selected;
+};
+
+// Layers carry no data, the app never has more than one menu at a time
+static MenuLayer* m_menu_layer = NULL;
+
+static uint16_t get_menu_row_count(MenuLayer* menu)
+{
+    return menu->callbacks.get_num_rows != NULL ? menu->callbacks.get_num_rows(menu, 0, menu->callback_context) : 0;
+}
+
+static void update_menu_layer(Layer* layer, GContext* ctx)
+{
+    MenuLayer* menu = m_menu_layer;
+    if(menu == NULL || menu->layer != layer)
+    {
+        return;
+    }
+    if(menu->callbacks.draw_header != NULL)
+    {
+        menu->callbacks.draw_header(ctx, layer, 0, menu->callback_context);
+    }
+    uint16_t rows = get_menu_row_count(menu);
+    for(uint16_t row = 0; row < rows; row++)
+    {
+        MenuIndex index = { .section = 0, .row = row };
+        menu->callbacks.draw_row(ctx, layer, &index, menu->callback_context);
+    }
+}
+
+MenuLayer* menu_layer_create(GRect frame)
+{
+    MenuLayer* menu = heap_calloc(1, sizeof(MenuLayer));
+    menu->layer = layer_create(frame);
+    layer_set_update_proc(menu->layer, update_menu_layer);
+    m_menu_layer = menu;
+    return menu;
+}
+
+void menu_layer_destroy(MenuLayer* menu_layer)
+{
+    if(menu_layer != NULL)
+    {
+        if(m_menu_layer == menu_layer)
+        {
+            m_menu_layer = NULL;
+        }
+        layer_destroy(menu_layer->layer);
+        heap_free(menu_layer);
+    }
+}
+
+Layer* menu_layer_get_layer(const MenuLayer* menu_layer)
+{
+    return menu_layer->layer;
+}
+
+void menu_layer_set_callbacks(MenuLayer* menu_layer, void* callback_context, MenuLayerCallbacks callbacks)
+{
+    menu_layer->callbacks = callbacks;
+    menu_layer->callback_context = callback_context;
+}
+
+static void handle_menu_up(ClickRecognizerRef recognizer, void* context)
+{
+    MenuLayer* menu = context;
+    if(menu->selected.row > 0)
+    {
+        menu->selected.row--;
+        m_render_pending = true;
+    }
+}
+
+static void handle_menu_down(ClickRecognizerRef recognizer, void* context)
+{
+    MenuLayer* menu = context;
+    if(menu->selected.row + 1 < get_menu_row_count(menu))
+    {
+        menu->selected.row++;
+        m_render_pending = true;
+    }
+}
+
+static void handle_menu_select(ClickRecognizerRef recognizer, void* context)
+{
+    MenuLayer* menu = context;
+    if(menu->callbacks.select_click != NULL)
+    {
+        menu->callbacks.select_click(menu, &menu->selected, menu->callback_context);
+    }
+}
+
+static void menu_click_config_provider(void* context)
+{
+    window_single_click_subscribe(BUTTON_ID_UP, handle_menu_up);
+    window_single_click_subscribe(BUTTON_ID_DOWN, handle_menu_down);
+    window_single_click_subscribe(BUTTON_ID_SELECT, handle_menu_select);
+}
+
+void menu_layer_set_click_config_onto_window(MenuLayer* menu_layer, Window* window)
+{
+    window->click_config_provider = menu_click_config_provider;
+    window->click_context = menu_layer;
+}
+
+void menu_layer_set_normal_colors(MenuLayer* menu_layer, GColor background, GColor foreground)
+{
+}
+
+void menu_layer_set_highlight_colors(MenuLayer* menu_layer, GColor background, GColor foreground)
+{
+}
+
+void menu_cell_basic_draw(GContext* ctx, const Layer* cell_layer, const char* title, const char* subtitle, GBitmap* icon)
+{
+    m_stats.draw_text_calls += subtitle != NULL ? 2 : 1;
+    if(m_verbose)
+    {
+        fprintf(stderr, "menu row: %s: %s\n", title, subtitle != NULL ? subtitle : "");
+    }
+}
+
+void menu_cell_basic_header_draw(GContext* ctx, const Layer* cell_layer, const char* title)
+{
+    m_stats.draw_text_calls++;
+}
+
+// Vibes and backlight
+
+static void update_light_time(uint64_t from_ms, uint64_t to_ms)
+{
+    if(m_light_on)
+    {
+        m_stats.lit_ms += to_ms - from_ms;
+    }
+}
+
+void vibes_enqueue_custom_pattern(VibePattern pattern)
+{
+    m_stats.vibes++;
+}
+
+void vibes_short_pulse(void)
+{
+    m_stats.vibes++;
+}
+
+void vibes_long_pulse(void)
+{
+    m_stats.vibes++;
+}
+
+void vibes_double_pulse(void)
+{
+    m_stats.vibes++;
+}
+
+void vibes_cancel(void)
+{
+}
+
+void light_enable(bool enable)
+{
+    m_light_on = enable;
+}
+
+void light_enable_interaction(void)
+{
+    m_stats.lit_ms += m_light_on ? 0 : 3000;
+}
+
+void exit_reason_set(AppExitReason reason)
+{
+}
+
+// Persistent storage
+
+typedef struct {
+    bool used;
+    uint32_t key;
+    int size;
+    uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} PersistEntry;
+
+static PersistEntry m_persist[MAX_PERSIST_KEYS];
+
+static PersistEntry* find_persist_entry(uint32_t key)
+{
+    for(int i = 0; i < MAX_PERSIST_KEYS; i++)
+    {
+        if(m_persist[i].used && m_persist[i].key == key)
+        {
+            return &m_persist[i];
+        }
+    }
+    return NULL;
+}
+
+bool persist_exists(const uint32_t key)
+{
+    m_stats.persist_reads++;
+    return find_persist_entry(key) != NULL;
+}
+
+int persist_get_size(const uint32_t key)
+{
+    m_stats.persist_reads++;
+    PersistEntry* entry = find_persist_entry(key);
+    return entry != NULL ? entry->size : -1;
+}
+
+int persist_read_data(const uint32_t key, void* buffer, const size_t buffer_size)
+{
+    m_stats.persist_reads++;
+    PersistEntry* entry = find_persist_entry(key);
+    if(entry == NULL)
+    {
+        return -1;
+    }
+    size_t size = (size_t)entry->size < buffer_size ? (size_t)entry->size : buffer_size;
+    memcpy(buffer, entry->data, size);
+    return size;
+}
+
+int persist_write_data(const uint32_t key, const void* data, const size_t size)
+{
+    PersistEntry* entry = find_persist_entry(key);
+    for(int i = 0; entry == NULL && i < MAX_PERSIST_KEYS; i++)
+    {
+        if(!m_persist[i].used)
+        {
+            entry = &m_persist[i];
+            entry->used = true;
+            entry->key = key;
+        }
+    }
+    if(entry == NULL)
+    {
+        return -1;
+    }
+    size_t written = size < PERSIST_DATA_MAX_LENGTH ? size : PERSIST_DATA_MAX_LENGTH;
+    memcpy(entry->data, data, written);
+    entry->size = written;
+    m_stats.persist_writes++;
+    m_stats.persist_bytes_written += written;
+    return written;
+}
+
+int32_t persist_read_int(const uint32_t key)
+{
+    int32_t value = 0;
+    persist_read_data(key, &value, sizeof(value));
+    return value;
+}
+
+int persist_write_int(const uint32_t key, const int32_t value)
+{
+    return persist_write_data(key, &value, sizeof(value));
+}
+
+int persist_delete(const uint32_t key)
+{
+    PersistEntry* entry = find_persist_entry(key);
+    if(entry != NULL)
+    {
+        entry->used = false;
+    }
+    return 0;
+}
+
+// Resources are read from the repository resources folder
+
+typedef struct {
+    uint32_t id;
+    const char* file;
+} ResourceFile;
+
+static const ResourceFile RESOURCE_FILES[] =
+{
+    { RESOURCE_ID_EXERCISE_LIBRARY, "data/exercises.bin" },
+};
+
+void sim_set_resource_dir(const char* path)
+{
+    m_resource_dir = path;
+}
+
+ResHandle resource_get_handle(uint32_t resource_id)
+{
+    for(size_t i = 0; i < ARRAY_LENGTH(RESOURCE_FILES); i++)
+    {
+        if(RESOURCE_FILES[i].id == resource_id)
+        {
+            return &RESOURCE_FILES[i];
+        }
+    }
+    return NULL;
+}
+
+static FILE* open_resource(ResHandle h)
+{
+    if(h == NULL)
+    {
+        return NULL;
+    }
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", m_resource_dir, ((const ResourceFile*)h)->file);
+    return fopen(path, "rb");
+}
+
+size_t resource_size(ResHandle h)
+{
+    FILE* file = open_resource(h);
+    if(file == NULL)
+    {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    size_t size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+size_t resource_load_byte_range(ResHandle h, uint32_t start_offset, uint8_t* buffer, size_t num_bytes)
+{
+    m_stats.resource_reads++;
+    FILE* file = open_resource(h);
+    if(file == NULL)
+    {
+        return 0;
+    }
+    fseek(file, start_offset, SEEK_SET);
+    size_t read = fread(buffer, 1, num_bytes, file);
+    fclose(file);
+    return read;
+}
+
+// Launching and wakeups, scheduled wakeups never fire on their own, the
+// simulation relaunches the app with sim_launch instead
+
+typedef struct {
+    bool active;
+    time_t timestamp;
+    int32_t cookie;
+} SimWakeup;
+
+static SimWakeup m_wakeups[MAX_WAKEUPS];
+
+AppLaunchReason launch_reason(void)
+{
+    return m_launch_reason;
+}
+
+void sim_launch(AppLaunchReason reason)
+{
+    m_launch_reason = reason;
+    m_launch_ms = m_now_ms;
+    m_launch_resource_reads = m_stats.resource_reads;
+    m_first_frame_pending = true;
+}
+
+WakeupId wakeup_schedule(time_t timestamp, int32_t cookie, bool notify_if_missed)
+{
+    if(timestamp <= time(NULL))
+    {
+        return E_INVALID_ARGUMENT;
+    }
+    int free_index = -1;
+    for(int i = 0; i < MAX_WAKEUPS; i++)
+    {
+        if(!m_wakeups[i].active)
+        {
+            free_index = free_index < 0 ? i : free_index;
+        } else if(labs((long)(m_wakeups[i].timestamp - timestamp)) < WAKEUP_SPACING_S)
+        {
+            return E_RANGE;
+        }
+    }
+    if(free_index < 0)
+    {
+        return E_OUT_OF_RESOURCES;
+    }
+    m_wakeups[free_index] = (SimWakeup) { .active = true, .timestamp = timestamp, .cookie = cookie };
+    m_stats.wakeups_scheduled++;
+    return free_index + 1;
+}
+
+static SimWakeup* get_wakeup(WakeupId wakeup_id)
+{
+    if(wakeup_id < 1 || wakeup_id > MAX_WAKEUPS || !m_wakeups[wakeup_id - 1].active)
+    {
+        return NULL;
+    }
+    return &m_wakeups[wakeup_id - 1];
+}
+
+void wakeup_cancel(WakeupId wakeup_id)
+{
+    SimWakeup* wakeup = get_wakeup(wakeup_id);
+    if(wakeup != NULL)
+    {
+        wakeup->active = false;
+    }
+}
+
+void wakeup_cancel_all(void)
+{
+    memset(m_wakeups, 0, sizeof(m_wakeups));
+}
+
+bool wakeup_query(WakeupId wakeup_id, time_t* timestamp)
+{
+    SimWakeup* wakeup = get_wakeup(wakeup_id);
+    if(wakeup != NULL && timestamp != NULL)
+    {
+        *timestamp = wakeup->timestamp;
+    }
+    return wakeup != NULL;
+}
+
+void wakeup_service_subscribe(WakeupHandler handler)
+{
+}
+
+// Dictionaries and AppMessage, a sent message is delivered to the phone
+// on the next sim_run_for_ms
+
+uint32_t MESSAGE_KEY_Settings = 10000;
+uint32_t MESSAGE_KEY_UploadId = 10016;
+uint32_t MESSAGE_KEY_UploadLength = 10017;
+uint32_t MESSAGE_KEY_UploadName = 10018;
+uint32_t MESSAGE_KEY_UploadOffset = 10019;
+uint32_t MESSAGE_KEY_UploadData = 10020;
+uint32_t MESSAGE_KEY_UploadAck = 10021;
+
+static uint32_t m_inbox_size = 0;
+static uint32_t m_outbox_size = 0;
+static bool m_app_message_open = false;
+static AppMessageInboxReceived m_inbox_received = NULL;
+static AppMessageInboxDropped m_inbox_dropped = NULL;
+static AppMessageOutboxSent m_outbox_sent = NULL;
+static AppMessageOutboxFailed m_outbox_failed = NULL;
+static Tuple m_outbox_tuples[MAX_DICT_TUPLES];
+static DictionaryIterator m_outbox;
+static bool m_outbox_in_flight = false;
+
+static uint32_t get_dict_size(const DictionaryIterator* iter)
+{
+    uint32_t size = 1;
+    for(uint16_t i = 0; i < iter->count; i++)
+    {
+        size += TUPLE_HEADER_SIZE + iter->tuples[i].length;
+    }
+    return size;
+}
+
+Tuple* dict_read_first(DictionaryIterator* iter)
+{
+    iter->cursor = 0;
+    return dict_read_next(iter);
+}
+
+Tuple* dict_read_next(DictionaryIterator* iter)
+{
+    return iter->cursor < iter->count ? &iter->tuples[iter->cursor++] : NULL;
+}
+
+Tuple* dict_find(const DictionaryIterator* iter, const uint32_t key)
+{
+    for(uint16_t i = 0; i < iter->count; i++)
+    {
+        if(iter->tuples[i].key == key)
+        {
+            return &iter->tuples[i];
+        }
+    }
+    return NULL;
+}
+
+static DictionaryResult dict_write_tuple(DictionaryIterator* iter, const Tuple* tuple)
+{
+    if(iter->count >= iter->capacity || get_dict_size(iter) + TUPLE_HEADER_SIZE + tuple->length > m_outbox_size)
+    {
+        return DICT_NOT_ENOUGH_STORAGE;
+    }
+    iter->tuples[iter->count++] = *tuple;
+    return DICT_OK;
+}
+
+DictionaryResult dict_write_int32(DictionaryIterator* iter, const uint32_t key, const int32_t value)
+{
+    Tuple tuple = { .key = key, .type = TUPLE_INT, .length = sizeof(int32_t) };
+    tuple.value->int32 = value;
+    return dict_write_tuple(iter, &tuple);
+}
+
+DictionaryResult dict_write_uint8(DictionaryIterator* iter, const uint32_t key, const uint8_t value)
+{
+    Tuple tuple = { .key = key, .type = TUPLE_UINT, .length = sizeof(uint8_t) };
+    tuple.value->uint8 = value;
+    return dict_write_tuple(iter, &tuple);
+}
+
+DictionaryResult dict_write_data(DictionaryIterator* iter, const uint32_t key, const uint8_t* data, const uint16_t size)
+{
+    if(size > sizeof(((Tuple*)NULL)->value->data))
+    {
+        return DICT_INVALID_ARGS;
+    }
+    Tuple tuple = { .key = key, .type = TUPLE_BYTE_ARRAY, .length = size };
+    memcpy(tuple.value->data, data, size);
+    return dict_write_tuple(iter, &tuple);
+}
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound)
+{
+    m_inbox_size = size_inbound;
+    m_outbox_size = size_outbound;
+    m_app_message_open = true;
+    return APP_MSG_OK;
+}
+
+void app_message_deregister_callbacks(void)
+{
+    m_inbox_received = NULL;
+    m_inbox_dropped = NULL;
+    m_outbox_sent = NULL;
+    m_outbox_failed = NULL;
+}
+
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback)
+{
+    AppMessageInboxReceived previous = m_inbox_received;
+    m_inbox_received = received_callback;
+    return previous;
+}
+
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback)
+{
+    AppMessageInboxDropped previous = m_inbox_dropped;
+    m_inbox_dropped = dropped_callback;
+    return previous;
+}
+
+AppMessageOutboxSent app_message_register_outbox_sent(AppMessageOutboxSent sent_callback)
+{
+    AppMessageOutboxSent previous = m_outbox_sent;
+    m_outbox_sent = sent_callback;
+    return previous;
+}
+
+AppMessageOutboxFailed app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback)
+{
+    AppMessageOutboxFailed previous = m_outbox_failed;
+    m_outbox_failed = failed_callback;
+    return previous;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator** iterator)
+{
+    if(!m_app_message_open)
+    {
+        return APP_MSG_CLOSED;
+    }
+    if(m_outbox_in_flight)
+    {
+        return APP_MSG_BUSY;
+    }
+    m_outbox = (DictionaryIterator) { .tuples = m_outbox_tuples, .capacity = MAX_DICT_TUPLES };
+    *iterator = &m_outbox;
+    return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_send(void)
+{
+    if(m_outbox_in_flight)
+    {
+        return APP_MSG_BUSY;
+    }
+    m_outbox_in_flight = true;
+    m_stats.app_messages_sent++;
+    m_stats.app_message_bytes += get_dict_size(&m_outbox);
+    return APP_MSG_OK;
+}
+
+static void complete_outbox_send()
+{
+    if(m_outbox_in_flight)
+    {
+        m_outbox_in_flight = false;
+        if(m_outbox_sent != NULL)
+        {
+            m_outbox_sent(&m_outbox, NULL);
+        }
+    }
+}
+
+const DictionaryIterator* sim_get_last_outbox()
+{
+    return &m_outbox;
+}
+
+// The worker is not part of the host build, a launched worker is only
+// counted and sessions are always taken back from storage
+bool app_worker_is_running(void)
+{
+    return false;
+}
+
+AppWorkerResult app_worker_launch(void)
+{
+    m_stats.worker_launches++;
+    return APP_WORKER_RESULT_SUCCESS;
+}
+
+AppWorkerResult app_worker_kill(void)
+{
+    return APP_WORKER_RESULT_NOT_RUNNING;
+}
+
+bool app_worker_message_subscribe(AppWorkerMessageHandler handler)
+{
+    return true;
+}
+
+bool app_worker_message_unsubscribe(void)
+{
+    return true;
+}
+
+void app_worker_send_message(uint8_t type, AppWorkerMessage* data)
+{
+}
+
+static BatteryChargeState m_battery = { .charge_percent = 100 };
+static BatteryStateHandler m_battery_handler = NULL;
+
+BatteryChargeState battery_state_service_peek(void)
+{
+    return m_battery;
+}
+
+void battery_state_service_subscribe(BatteryStateHandler handler)
+{
+    m_battery_handler = handler;
+}
+
+void battery_state_service_unsubscribe(void)
+{
+    m_battery_handler = NULL;
+}
+
+size_t heap_bytes_used(void)
+{
+    return m_heap_used;
+}
+
+size_t heap_bytes_free(void)
+{
+    return SIM_HEAP_SIZE > m_heap_used ? SIM_HEAP_SIZE - m_heap_used : 0;
+}
+
+AppGlanceResult app_glance_add_slice(AppGlanceReloadSession* session, AppGlanceSlice slice)
+{
+    return APP_GLANCE_RESULT_SUCCESS;
+}
+
+void app_glance_reload(AppGlanceReloadCallback callback, void* context)
+{
+    callback(NULL, 1, context);
+}
+
+// Event loop
+
+static void render_if_pending()
+{
+    Window* window = get_top_window();
+    if(m_render_pending && window != NULL && m_now_ms >= m_render_not_before_ms)
+    {
+        m_render_pending = false;
+        m_stats.renders++;
+        render_layer(window->root_layer, GPointZero, GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT));
+        if(m_first_frame_pending)
+        {
+            m_first_frame_pending = false;
+            m_stats.first_frame_ms = m_now_ms - m_launch_ms;
+            m_stats.first_frame_resource_reads = m_stats.resource_reads - m_launch_resource_reads;
+        }
+    }
+}
+
+void sim_set_battery(uint8_t charge_percent, bool is_charging)
+{
+    m_battery.charge_percent = charge_percent;
+    m_battery.is_charging = is_charging;
+    m_battery.is_plugged = is_charging;
+    if(m_battery_handler != NULL)
+    {
+        m_battery_handler(m_battery);
+        render_if_pending();
+    }
+}
+
+static UnobstructedAreaHandlers m_unobstructed_area_handlers;
+static void* m_unobstructed_area_context = NULL;
+
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void* context)
+{
+    m_unobstructed_area_handlers = handlers;
+    m_unobstructed_area_context = context;
+}
+
+void unobstructed_area_service_unsubscribe(void)
+{
+    memset(&m_unobstructed_area_handlers, 0, sizeof(m_unobstructed_area_handlers));
+    m_unobstructed_area_context = NULL;
+}
+
+void sim_set_obstructed_height(int16_t height)
+{
+    m_obstructed_height = height;
+    if(m_unobstructed_area_handlers.did_change != NULL)
+    {
+        m_unobstructed_area_handlers.did_change(m_unobstructed_area_context);
+        render_if_pending();
+    }
+}
+
+void sim_receive_app_message(const Tuple* tuples, uint16_t count)
+{
+    DictionaryIterator iterator = { .tuples = (Tuple*)tuples, .count = count, .capacity = count };
+    uint32_t size = get_dict_size(&iterator);
+    if(!m_app_message_open || size > m_inbox_size)
+    {
+        m_stats.app_messages_dropped++;
+        if(m_inbox_dropped != NULL)
+        {
+            m_inbox_dropped(APP_MSG_BUFFER_OVERFLOW, NULL);
+        }
+        return;
+    }
+    m_stats.app_messages_received++;
+    m_stats.app_message_bytes += size;
+    if(m_inbox_received != NULL)
+    {
+        m_inbox_received(&iterator, NULL);
+    }
+    render_if_pending();
+}
+
+static AppTimer* get_next_timer()
+{
+    AppTimer* next = NULL;
+    for(int i = 0; i < MAX_TIMERS; i++)
+    {
+        if(m_timers[i].active && (next == NULL || m_timers[i].fire_ms < next->fire_ms))
+        {
+            next = &m_timers[i];
+        }
+    }
+    return next;
+}
+
+static void advance_clock(uint64_t to_ms)
+{
+    update_light_time(m_now_ms, to_ms);
+    m_stats.elapsed_ms += to_ms - m_now_ms;
+    m_now_ms = to_ms;
+}
+
+void sim_run_for_ms(uint64_t duration_ms)
+{
+    uint64_t end_ms = m_now_ms + duration_ms;
+    complete_outbox_send();
+    render_if_pending();
+    while(true)
+    {
+        AppTimer* timer = get_next_timer();
+        uint64_t next_tick_ms = m_tick_handler != NULL ? (m_now_ms / 1000 + 1) * 1000 : UINT64_MAX;
+        uint64_t next_timer_ms = timer != NULL ? timer->fire_ms : UINT64_MAX;
+        uint64_t next_ms = next_tick_ms < next_timer_ms ? next_tick_ms : next_timer_ms;
+        bool animating = m_render_pending && m_render_not_before_ms > m_now_ms;
+        if(animating && m_render_not_before_ms < next_ms && m_render_not_before_ms <= end_ms)
+        {
+            advance_clock(m_render_not_before_ms);
+            render_if_pending();
+            continue;
+        }
+        if(next_ms > end_ms)
+        {
+            break;
+        }
+
+        advance_clock(next_ms);
+        if(next_ms == next_timer_ms)
+        {
+            timer->active = false;
+            m_stats.timer_wakeups++;
+            timer->callback(timer->data);
+        } else
+        {
+            time_t now = next_ms / 1000;
+            m_stats.tick_wakeups++;
+            m_tick_handler(localtime(&now), m_tick_units);
+        }
+        render_if_pending();
+    }
+    advance_clock(end_ms);
+}
+
+void app_event_loop(void)
+{
+    while(sim_has_pending_timers() && get_top_window() != NULL)
+    {
+        sim_run_for_ms(1000);
+    }
+}
+
+const uint8_t* sim_get_frame_buffer()
+{
+    return m_frame_buffer_data;
+}
+
+const SimStats* sim_get_stats()
+{
+    return &m_stats;
+}
+
+void sim_print_stats(FILE* out)
+{
+    fprintf(out, "virtual time:          %llu ms\n", (unsigned long long)m_stats.elapsed_ms);
+    fprintf(out, "timer wakeups:         %u\n", m_stats.timer_wakeups);
+    fprintf(out, "tick wakeups:          %u\n", m_stats.tick_wakeups);
+    fprintf(out, "renders:               %u\n", m_stats.renders);
+    fprintf(out, "update proc calls:     %u\n", m_stats.update_proc_calls);
+    fprintf(out, "update proc time:      %llu us (max %llu us)\n",
+        (unsigned long long)(m_stats.update_proc_ns / 1000),
+        (unsigned long long)(m_stats.max_update_proc_ns / 1000));
+    fprintf(out, "frame buffer changes:  %llu bytes\n", (unsigned long long)m_stats.frame_buffer_bytes_changed);
+    fprintf(out, "fill rect/circle/radial/text: %u/%u/%u/%u\n",
+        m_stats.fill_rect_calls, m_stats.fill_circle_calls, m_stats.fill_radial_calls, m_stats.draw_text_calls);
+    fprintf(out, "vibes:                 %u\n", m_stats.vibes);
+    fprintf(out, "backlight on:          %llu ms\n", (unsigned long long)m_stats.lit_ms);
+    fprintf(out, "worker launches:       %u\n", m_stats.worker_launches);
+    fprintf(out, "wakeups scheduled:     %u\n", m_stats.wakeups_scheduled);
+    fprintf(out, "app messages sent/received/dropped: %u/%u/%u (%u bytes)\n",
+        m_stats.app_messages_sent, m_stats.app_messages_received, m_stats.app_messages_dropped, m_stats.app_message_bytes);
+    fprintf(out, "launch to first frame: %llu ms (%u resource reads)\n",
+        (unsigned long long)m_stats.first_frame_ms, m_stats.first_frame_resource_reads);
+    fprintf(out, "persist reads/writes:  %u/%u (%u bytes written)\n",
+        m_stats.persist_reads, m_stats.persist_writes, m_stats.persist_bytes_written);
+    fprintf(out, "resource reads:        %u\n", m_stats.resource_reads);
+    fprintf(out, "log lines:             %u\n", m_stats.log_lines);
+    fprintf(out, "live bitmaps/layers/windows: %d/%d/%d\n",
+        m_stats.live_bitmaps, m_stats.live_layers, m_stats.live_windows);
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <pebble.h>
+
+// Counters collected by the shim while the app runs on the virtual clock
+typedef struct {
+    uint64_t elapsed_ms;
+    uint32_t timer_wakeups;
+    uint32_t tick_wakeups;
+    uint32_t renders;
+    uint32_t update_proc_calls;
+    uint64_t update_proc_ns;
+    uint64_t max_update_proc_ns;
+    uint64_t frame_buffer_bytes_changed;
+    uint32_t fill_rect_calls;
+    uint32_t fill_circle_calls;
+    uint32_t fill_radial_calls;
+    uint32_t draw_text_calls;
+    uint32_t vibes;
+    uint64_t lit_ms;
+    uint32_t worker_launches;
+    uint32_t app_messages_sent;
+    uint32_t app_messages_received;
+    uint32_t app_messages_dropped;
+    uint32_t app_message_bytes;
+    uint32_t wakeups_scheduled;
+    uint64_t first_frame_ms;
+    uint32_t first_frame_resource_reads;
+    uint32_t persist_reads;
+    uint32_t persist_writes;
+    uint32_t persist_bytes_written;
+    uint32_t resource_reads;
+    uint32_t log_lines;
+    int32_t live_bitmaps;
+    int32_t live_layers;
+    int32_t live_windows;
+} SimStats;
+
+void sim_set_verbose(bool verbose);
+void sim_set_resource_dir(const char* path);
+uint64_t sim_now_ms();
+void sim_run_for_ms(uint64_t duration_ms);
+bool sim_has_pending_timers();
+void sim_click(ButtonId button_id);
+void sim_long_click(ButtonId button_id);
+void sim_set_battery(uint8_t charge_percent, bool is_charging);
+// Covers the bottom of the screen the way a timeline quick view peek does
+void sim_set_obstructed_height(int16_t height);
+// Delivers a message from the phone, dropped when it does not fit the
+// inbox the app opened
+void sim_receive_app_message(const Tuple* tuples, uint16_t count);
+// Tuples of the last message the app sent
+const DictionaryIterator* sim_get_last_outbox();
+// Call before init, the time and resource reads until the first render
+// after it are reported as the launch cost
+void sim_launch(AppLaunchReason reason);
+const uint8_t* sim_get_frame_buffer();
+const SimStats* sim_get_stats();
+void sim_print_stats(FILE* out);
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+// Normally generated by the SDK from package.json
+enum {
+    RESOURCE_ID_EXERCISE_LIBRARY = 1,
+    RESOURCE_ID_CONFIG_BLACK_ICON,
+    RESOURCE_ID_CONFIG_WHITE_ICON,
+    RESOURCE_ID_BREATH_ICON,
+    RESOURCE_ID_PLAY_WHITE_ICON,
+    RESOURCE_ID_PLAY_BLACK_ICON,
+    RESOURCE_ID_PAUSE_BLACK_ICON,
+    RESOURCE_ID_PAUSE_WHITE_ICON,
+    RESOURCE_ID_SWAP_BLACK_ICON,
+    RESOURCE_ID_SWAP_WHITE_ICON,
+    RESOURCE_ID_CONFIG_ICON,
+    RESOURCE_ID_PLAY_ICON,
+    RESOURCE_ID_PAUSE_ICON,
+    RESOURCE_ID_SWAP_ICON,
+};
+
+#define PUBLISHED_ID_APP_GLANCE_ICON (RESOURCE_ID_BREATH_ICON)
\ No newline at end of file
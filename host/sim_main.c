@@ -0,0 +1,136 @@
+#include "pebble_sim.h"
+
+#include <unistd.h>
+
+#include "app.h"
+#include "persistance.h"
+
+#define MAX_SESSION_MS (60 * 60 * 1000)
+#define CLOSED_MS (10 * 1000)
+// Height of a timeline quick view peek on the 144x168 display
+#define QUICK_VIEW_HEIGHT (51)
+#define REMINDER_HOUR (8)
+
+static void print_usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-v] [-H] [-b backlight mode] [-B battery[@ms]] [-c ms] [-q ms] [-w] [-e exercise] [-r resource dir]\n", name);
+    fprintf(stderr, "  Runs one full breathing session on a virtual clock and prints\n");
+    fprintf(stderr, "  wakeup, render, storage and vibe counters.\n");
+    fprintf(stderr, "  -H runs the session in haptic only mode.\n");
+    fprintf(stderr, "  -b sets the backlight mode, 0 off, 1 flash, 2 dim holds, 3 always on.\n");
+    fprintf(stderr, "  -B sets the battery percentage, from the start or after ms into the session.\n");
+    fprintf(stderr, "  -c closes the app ms into the session and relaunches it 10 s later.\n");
+    fprintf(stderr, "  -q shows a timeline quick view peek ms into the session.\n");
+    fprintf(stderr, "  -w launches the app from a reminder wakeup instead of the menu.\n");
+}
+
+int main(int argc, char** argv)
+{
+    int exercise = 0;
+    bool haptic_only = false;
+    int backlight_mode = -1;
+    int battery_percent = -1;
+    uint64_t battery_at_ms = 0;
+    uint64_t close_at_ms = 0;
+    bool reminder_launch = false;
+    uint64_t quick_view_at_ms = 0;
+    int option;
+    while((option = getopt(argc, argv, "vHb:B:c:q:we:r:h")) != -1)
+    {
+        switch(option)
+        {
+            case 'v':
+                sim_set_verbose(true);
+                break;
+            case 'H':
+                haptic_only = true;
+                break;
+            case 'b':
+                backlight_mode = atoi(optarg) % BACKLIGHT_MODE_COUNT;
+                break;
+            case 'B':
+            {
+                battery_percent = atoi(optarg);
+                const char* at = strchr(optarg, '@');
+                battery_at_ms = at != NULL ? strtoull(at + 1, NULL, 10) : 0;
+                break;
+            }
+            case 'c':
+                close_at_ms = strtoull(optarg, NULL, 10);
+                break;
+            case 'q':
+                quick_view_at_ms = strtoull(optarg, NULL, 10);
+                break;
+            case 'w':
+                reminder_launch = true;
+                break;
+            case 'e':
+                exercise = atoi(optarg);
+                break;
+            case 'r':
+                sim_set_resource_dir(optarg);
+                break;
+            default:
+                print_usage(argv[0]);
+                return option == 'h' ? 0 : 1;
+        }
+    }
+
+    set_haptic_only(haptic_only);
+    if(backlight_mode >= 0)
+    {
+        set_backlight_mode(backlight_mode);
+    }
+
+    if(battery_percent >= 0 && battery_at_ms == 0)
+    {
+        sim_set_battery(battery_percent, false);
+    }
+
+    if(reminder_launch && !has_reminder())
+    {
+        set_reminder_hour(REMINDER_HOUR);
+    }
+
+    sim_launch(reminder_launch ? APP_LAUNCH_WAKEUP : APP_LAUNCH_USER);
+    init();
+    sim_run_for_ms(100);
+
+    // A reminder launch is already breathing the selected exercise
+    if(!reminder_launch)
+    {
+        for(int i = 0; i < exercise; i++)
+        {
+            sim_click(BUTTON_ID_UP);
+        }
+        sim_click(BUTTON_ID_SELECT);
+    }
+
+    uint64_t start_ms = sim_now_ms();
+    if(battery_percent >= 0 && battery_at_ms > 0)
+    {
+        sim_run_for_ms(battery_at_ms);
+        sim_set_battery(battery_percent, false);
+    }
+    if(quick_view_at_ms > 0)
+    {
+        sim_run_for_ms(quick_view_at_ms);
+        sim_set_obstructed_height(QUICK_VIEW_HEIGHT);
+    }
+    if(close_at_ms > 0)
+    {
+        sim_run_for_ms(close_at_ms);
+        deinit();
+        sim_run_for_ms(CLOSED_MS);
+        sim_launch(APP_LAUNCH_USER);
+        init();
+    }
+    while(sim_has_pending_timers() && sim_now_ms() - start_ms < MAX_SESSION_MS)
+    {
+        sim_run_for_ms(1000);
+    }
+
+    deinit();
+    sim_print_stats(stdout);
+    return 0;
+}
\ No newline at end of file
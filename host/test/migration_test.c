@@ -0,0 +1,199 @@
+#include "pebble_sim.h"
+
+// Built into the persistance module so the statics can be reset between
+// cases and load_data can be called directly
+#include "persistance.c"
+
+static int m_failures = 0;
+
+#define CHECK_FIELD(name, actual, expected) check_field(name, #actual, (int)(actual), (int)(expected))
+
+static void check_field(const char* name, const char* field, int actual, int expected)
+{
+    if(actual != expected)
+    {
+        printf("FAIL %s: %s is %d, expected %d\n", name, field, actual, expected);
+        m_failures++;
+    }
+}
+
+static void reset_storage()
+{
+    persist_delete(DATA_KEY);
+    persist_delete(LEGACY_DATA_KEY);
+    memset(&m_data, 0, sizeof(Data));
+    m_data_loaded = false;
+    m_data_dirty = false;
+    m_legacy_data_present = false;
+}
+
+// Loads what the case stored, saves it and checks the result is a
+// current blob under DATA_KEY with the legacy key gone
+static void check_migration(const char* name, const Data* expected)
+{
+    load_data();
+    CHECK_FIELD(name, gcolor_equal(m_data.background_color, expected->background_color), true);
+    CHECK_FIELD(name, gcolor_equal(m_data.foreground_color, expected->foreground_color), true);
+    CHECK_FIELD(name, m_data.short_quad_time, expected->short_quad_time);
+    CHECK_FIELD(name, m_data.long_quad_time, expected->long_quad_time);
+    CHECK_FIELD(name, m_data.current_is_long, expected->current_is_long);
+    CHECK_FIELD(name, m_data.auto_start, expected->auto_start);
+    CHECK_FIELD(name, m_data.auto_kill, expected->auto_kill);
+    CHECK_FIELD(name, m_data.exercise_index, expected->exercise_index);
+    CHECK_FIELD(name, m_data.haptic_only, expected->haptic_only);
+    CHECK_FIELD(name, m_data.backlight_mode, expected->backlight_mode);
+    CHECK_FIELD(name, m_data.reduced_battery_threshold, expected->reduced_battery_threshold);
+    CHECK_FIELD(name, m_data.minimal_battery_threshold, expected->minimal_battery_threshold);
+    CHECK_FIELD(name, m_data.reminder_hour, expected->reminder_hour);
+
+    flush_data();
+    PersistedData saved;
+    CHECK_FIELD(name, persist_read_data(DATA_KEY, &saved, sizeof(PersistedData)), sizeof(PersistedData));
+    CHECK_FIELD(name, saved.data_version, CURRENT_DATA_VERSION);
+    CHECK_FIELD(name, persist_exists(LEGACY_DATA_KEY), false);
+
+    // The saved blob loads back to the same settings
+    Data migrated = m_data;
+    m_data_loaded = false;
+    load_data();
+    CHECK_FIELD(name, memcmp(&m_data, &migrated, sizeof(Data)), 0);
+}
+
+static Data get_seeded_data()
+{
+    return (Data) {
+        .background_color = GColorBlack,
+        .foreground_color = GColorWhite,
+        .short_quad_time = 15,
+        .long_quad_time = 35,
+        .current_is_long = true,
+        .backlight_mode = BacklightAlwaysOn,
+        .reduced_battery_threshold = 30,
+        .minimal_battery_threshold = 10,
+        .reminder_hour = NO_REMINDER,
+    };
+}
+
+static void store_v1(uint8_t version)
+{
+    DataV1 v1 =
+    {
+        .background_color = GColorWhite,
+        .foreground_color = GColorBlack,
+        .short_quad_time = 20,
+        .long_quad_time = 45,
+        .current_is_long = false,
+        .data_version = version,
+        .auto_start = true,
+        .auto_kill = true,
+    };
+    persist_write_data(LEGACY_DATA_KEY, &v1, sizeof(DataV1));
+}
+
+// The settings the v1 blob holds, with the defaults of every later version
+static Data get_v1_data()
+{
+    Data data = get_seeded_data();
+    data.background_color = GColorWhite;
+    data.foreground_color = GColorBlack;
+    data.short_quad_time = 20;
+    data.long_quad_time = 45;
+    data.current_is_long = false;
+    data.auto_start = true;
+    data.auto_kill = true;
+    return data;
+}
+
+// A blob of the given packed version, fields that version did not have
+// are left zero like the migrations find them
+static void store_packed(uint8_t version)
+{
+    PersistedData packed;
+    memset(&packed, 0, sizeof(PersistedData));
+    packed.data_version = version;
+    packed.short_quad_time = 25;
+    packed.long_quad_time = 50;
+    packed.current_is_long = 1;
+    packed.dark_theme = 0;
+    packed.auto_start = 1;
+    packed.auto_kill = 0;
+    packed.exercise_index = 3;
+    if(version >= 3)
+    {
+        packed.haptic_only = 1;
+    }
+    if(version >= 4)
+    {
+        packed.backlight_mode = BacklightDimHolds;
+    }
+    if(version >= 5)
+    {
+        packed.reduced_battery_threshold = 4;
+        packed.minimal_battery_threshold = 2;
+    }
+    if(version >= 6)
+    {
+        packed.reminder = 7 + 1;
+    }
+    persist_write_data(DATA_KEY, &packed, sizeof(PersistedData));
+}
+
+static Data get_packed_data(uint8_t version)
+{
+    Data data = get_seeded_data();
+    data.background_color = GColorWhite;
+    data.foreground_color = GColorBlack;
+    data.short_quad_time = 25;
+    data.long_quad_time = 50;
+    data.current_is_long = true;
+    data.auto_start = true;
+    data.auto_kill = false;
+    data.exercise_index = 3;
+    data.haptic_only = version >= 3;
+    if(version >= 4)
+    {
+        data.backlight_mode = BacklightDimHolds;
+    }
+    if(version >= 5)
+    {
+        data.reduced_battery_threshold = 40;
+        data.minimal_battery_threshold = 20;
+    }
+    if(version >= 6)
+    {
+        data.reminder_hour = 7;
+    }
+    return data;
+}
+
+int main()
+{
+    Data expected;
+
+    reset_storage();
+    expected = get_seeded_data();
+    check_migration("no data", &expected);
+
+    reset_storage();
+    store_v1(0);
+    expected = get_seeded_data();
+    check_migration("v0", &expected);
+
+    reset_storage();
+    store_v1(1);
+    expected = get_v1_data();
+    check_migration("v1", &expected);
+
+    for(uint8_t version = 2; version <= CURRENT_DATA_VERSION; version++)
+    {
+        char name[8];
+        snprintf(name, sizeof(name), "v%d", version);
+        reset_storage();
+        store_packed(version);
+        expected = get_packed_data(version);
+        check_migration(name, &expected);
+    }
+
+    printf("%s: %d failures\n", m_failures == 0 ? "PASS" : "FAIL", m_failures);
+    return m_failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -1,23 +1,82 @@
 #include "app.h"
 
 #include "main_window.h"
+#include "main_window_logic.h"
 #include "config_menu_window.h"
 
 #include "icons.h"
 #include "app_glance.h"
 #include "persistance.h"
+#include "reminders.h"
+#include "phone_link.h"
+#include "profiler.h"
+#include "heap_tracker.h"
+
+#define LOG_MODULE_LEVEL LOG_LEVEL_APP
+#include "log.h"
+
+// Work the reminder launch leaves until the session is already breathing
+#define DEFERRED_SETUP_DELAY_MS (1000)
+
+static AppTimer* m_deferred_setup_timer = NULL;
+
+static void handle_settings_received()
+{
+    schedule_reminder();
+    refresh_main_window();
+    refresh_config_menu_window();
+}
+
+static const PhoneLinkHandlers PHONE_LINK_HANDLERS =
+{
+    .settings_received = handle_settings_received,
+    .custom_exercise_changed = reload_custom_exercise,
+};
+
+static void finish_deferred_setup(void* data)
+{
+    m_deferred_setup_timer = NULL;
+    load_deferred_action_bar_icons();
+    schedule_reminder();
+    open_phone_link(PHONE_LINK_HANDLERS);
+}
 
 void init()
 {
+    PROFILE_LAUNCH();
+    subscribe_reminders(start_breathing);
+
+    if(launch_reason() == APP_LAUNCH_WAKEUP)
+    {
+        setup_main_window_for_reminder();
+        m_deferred_setup_timer = app_timer_register(DEFERRED_SETUP_DELAY_MS, finish_deferred_setup, NULL);
+        return;
+    }
+
     setup_main_window(get_background_color(), get_foreground_color());
+    ensure_reminder_scheduled();
+    open_phone_link(PHONE_LINK_HANDLERS);
 }
 
 void deinit()
 {
-    APP_LOG(APP_LOG_LEVEL_INFO, "Deiniting Brush");
+    LOG_INFO("Deiniting Brush");
+
+    if(m_deferred_setup_timer != NULL)
+    {
+        app_timer_cancel(m_deferred_setup_timer);
+        m_deferred_setup_timer = NULL;
+        // The reminder was dismissed right away, the wakeup that launched
+        // the app is used up so the next one still has to be scheduled
+        schedule_reminder();
+    }
 
+    close_phone_link();
     tear_down_main_window();
     tear_down_config_menu_window();
     destroy_all_icons();
     setup_app_glance();
+    flush_data();
+    // Everything tracked is destroyed by now, what is left leaked
+    HEAP_REPORT();
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <pebble.h>
 
+#include "log.h"
+
 static void set_app_glance(AppGlanceReloadSession *session, size_t limit, void *context)
 {
     if (limit < 1) return;
@@ -15,7 +17,7 @@ static void set_app_glance(AppGlanceReloadSession *session, size_t limit, void *
 
     const AppGlanceResult result = app_glance_add_slice(session, entry);
     if (result != APP_GLANCE_RESULT_SUCCESS) {
-        APP_LOG(APP_LOG_LEVEL_ERROR, "AppGlance Error: %d", result);
+        LOG_ERROR("AppGlance Error: %d", result);
     }
 }
 
@@ -0,0 +1,101 @@
+#include "backlight.h"
+
+#include "session_timeline.h"
+
+// How long light_enable_interaction keeps the light on with the default
+// system setting, only used to account for lit time
+#define INTERACTION_LIGHT_MS (3000)
+
+const char* const BACKLIGHT_MODE_NAMES[BACKLIGHT_MODE_COUNT] =
+{
+    [BacklightOff] = "Off",
+    [BacklightFlash] = "Flash",
+    [BacklightDimHolds] = "Dim holds",
+    [BacklightAlwaysOn] = "Always on",
+};
+
+static BacklightMode m_mode = BacklightOff;
+static bool m_enabled = false;
+
+// Lit time is counted from m_lit_since_ms up to m_lit_until_ms or now,
+// whichever comes first
+static uint64_t m_lit_since_ms = 0;
+static uint64_t m_lit_until_ms = 0;
+static uint32_t m_lit_ms = 0;
+
+static void account_lit_time()
+{
+    uint64_t now = get_now_ms();
+    uint64_t lit_end = now < m_lit_until_ms ? now : m_lit_until_ms;
+    if(lit_end > m_lit_since_ms)
+    {
+        m_lit_ms += (uint32_t)(lit_end - m_lit_since_ms);
+    }
+    m_lit_since_ms = now;
+}
+
+static void set_light(bool enabled)
+{
+    account_lit_time();
+    m_lit_until_ms = enabled ? UINT64_MAX : m_lit_since_ms;
+    if(enabled != m_enabled)
+    {
+        light_enable(enabled);
+        m_enabled = enabled;
+    }
+}
+
+static void flash_light()
+{
+    set_light(false);
+    light_enable_interaction();
+    m_lit_until_ms = m_lit_since_ms + INTERACTION_LIGHT_MS;
+}
+
+static bool is_hold(const Action* action)
+{
+    return action->type == HoldFullBreath || action->type == HoldEmptyBreath;
+}
+
+void start_backlight(BacklightMode mode, const Action* action)
+{
+    m_mode = mode;
+    update_backlight(action);
+}
+
+void update_backlight(const Action* action)
+{
+    switch (m_mode)
+    {
+        case BacklightFlash:
+            flash_light();
+            break;
+        case BacklightDimHolds:
+            set_light(!is_hold(action));
+            break;
+        case BacklightAlwaysOn:
+            set_light(true);
+            break;
+        default:
+            set_light(false);
+            break;
+    }
+}
+
+void stop_backlight()
+{
+    set_light(false);
+    m_mode = BacklightOff;
+}
+
+void reset_backlight_lit_time()
+{
+    account_lit_time();
+    m_lit_ms = 0;
+}
+
+uint32_t get_backlight_lit_ms()
+{
+    account_lit_time();
+    return m_lit_ms;
+}
\ No newline at end of file
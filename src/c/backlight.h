@@ -0,0 +1,23 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "exercise_program.h"
+
+// Stored in two bits of the settings, keep the values stable
+typedef enum {
+    BacklightOff,
+    BacklightFlash,
+    BacklightDimHolds,
+    BacklightAlwaysOn,
+    BACKLIGHT_MODE_COUNT,
+} BacklightMode;
+
+extern const char* const BACKLIGHT_MODE_NAMES[BACKLIGHT_MODE_COUNT];
+
+void start_backlight(BacklightMode mode, const Action* action);
+void update_backlight(const Action* action);
+void stop_backlight();
+
+void reset_backlight_lit_time();
+uint32_t get_backlight_lit_ms();
\ No newline at end of file
@@ -0,0 +1,340 @@
+#include "breath_renderer.h"
+
+#include "persistance.h"
+
+#define QUARTER_TURN (TRIG_MAX_ANGLE / 4)
+
+typedef enum {
+    ShapeNONE,
+    ShapeCircle,
+    ShapeArc,
+} Shape;
+
+typedef void (*SpanKernel)(uint8_t* row, int16_t x0, int16_t x1, GColor8 color);
+
+typedef struct {
+    GBitmap* frame_buffer;
+    SpanKernel fill_span;
+    GRect clip;
+    GPoint center;
+} Canvas;
+
+static GPoint m_center;
+static GPoint m_screen_offset;
+
+static Shape m_drawn_shape = ShapeNONE;
+static uint16_t m_drawn_radius;
+static int32_t m_drawn_angle;
+
+static void fill_span_1bit(uint8_t* row, int16_t x0, int16_t x1, GColor8 color)
+{
+    uint8_t fill = gcolor_equal(color, GColorWhite) ? 0xFF : 0x00;
+    int16_t first_byte = x0 >> 3;
+    int16_t last_byte = x1 >> 3;
+    uint8_t first_mask = 0xFF << (x0 & 7);
+    uint8_t last_mask = 0xFF >> (7 - (x1 & 7));
+
+    if(first_byte == last_byte)
+    {
+        uint8_t mask = first_mask & last_mask;
+        row[first_byte] = (row[first_byte] & ~mask) | (fill & mask);
+        return;
+    }
+
+    row[first_byte] = (row[first_byte] & ~first_mask) | (fill & first_mask);
+    if(last_byte - first_byte > 1)
+    {
+        memset(&row[first_byte + 1], fill, last_byte - first_byte - 1);
+    }
+    row[last_byte] = (row[last_byte] & ~last_mask) | (fill & last_mask);
+}
+
+static void fill_span_8bit(uint8_t* row, int16_t x0, int16_t x1, GColor8 color)
+{
+    memset(&row[x0], color.argb, x1 - x0 + 1);
+}
+
+static bool begin_canvas(Canvas* canvas, Layer* layer, GContext* ctx)
+{
+    GBitmap* frame_buffer = graphics_capture_frame_buffer(ctx);
+    if(frame_buffer == NULL)
+    {
+        return false;
+    }
+
+    switch(gbitmap_get_format(frame_buffer))
+    {
+        case GBitmapFormat1Bit:
+            canvas->fill_span = fill_span_1bit;
+            break;
+        case GBitmapFormat8Bit:
+        case GBitmapFormat8BitCircular:
+            canvas->fill_span = fill_span_8bit;
+            break;
+        default:
+            graphics_release_frame_buffer(ctx, frame_buffer);
+            return false;
+    }
+
+    // The frame buffer is in screen coordinates
+    GRect bounds = layer_get_bounds(layer);
+    canvas->frame_buffer = frame_buffer;
+    canvas->clip = GRect(m_screen_offset.x, m_screen_offset.y, bounds.size.w, bounds.size.h);
+    canvas->center = GPoint(m_screen_offset.x + m_center.x, m_screen_offset.y + m_center.y);
+    return true;
+}
+
+static void end_canvas(Canvas* canvas, GContext* ctx)
+{
+    graphics_release_frame_buffer(ctx, canvas->frame_buffer);
+}
+
+static void fill_span(Canvas* canvas, int16_t y, int16_t x0, int16_t x1, GColor8 color)
+{
+    GRect clip = canvas->clip;
+    if(y < clip.origin.y || y >= clip.origin.y + clip.size.h)
+    {
+        return;
+    }
+
+    GBitmapDataRowInfo row = gbitmap_get_data_row_info(canvas->frame_buffer, y);
+    int16_t min_x = clip.origin.x > row.min_x ? clip.origin.x : row.min_x;
+    int16_t max_x = clip.origin.x + clip.size.w - 1;
+    if(max_x > row.max_x)
+    {
+        max_x = row.max_x;
+    }
+    if(x0 < min_x)
+    {
+        x0 = min_x;
+    }
+    if(x1 > max_x)
+    {
+        x1 = max_x;
+    }
+    if(x0 <= x1)
+    {
+        canvas->fill_span(row.data, x0, x1, color);
+    }
+}
+
+static int16_t isqrt(int32_t value)
+{
+    if(value < 0)
+    {
+        return -1;
+    }
+    int32_t root = 0;
+    int32_t bit = 1 << 30;
+    while(bit > value)
+    {
+        bit >>= 2;
+    }
+    while(bit != 0)
+    {
+        if(value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+static int16_t get_half_width(int16_t radius, int16_t dy)
+{
+    if(radius < 0 || dy > radius || dy < -radius)
+    {
+        return -1;
+    }
+    return isqrt((int32_t)radius * radius - (int32_t)dy * dy);
+}
+
+// Paints the pixels inside the outer disc but outside the inner one,
+// an inner radius of -1 paints the whole outer disc
+static void paint_ring(Canvas* canvas, int16_t inner, int16_t outer, GColor8 color)
+{
+    GPoint c = canvas->center;
+    for(int16_t dy = -outer; dy <= outer; dy++)
+    {
+        int16_t outer_half = get_half_width(outer, dy);
+        int16_t inner_half = get_half_width(inner, dy);
+        if(inner_half < 0)
+        {
+            fill_span(canvas, c.y + dy, c.x - outer_half, c.x + outer_half, color);
+        } else if(outer_half > inner_half)
+        {
+            fill_span(canvas, c.y + dy, c.x - outer_half, c.x - inner_half - 1, color);
+            fill_span(canvas, c.y + dy, c.x + inner_half + 1, c.x + outer_half, color);
+        }
+    }
+}
+
+static GPoint get_arc_point(int32_t angle, int16_t radius)
+{
+    return GPoint(
+        (sin_lookup(angle) * radius) / TRIG_MAX_RATIO,
+        (-cos_lookup(angle) * radius) / TRIG_MAX_RATIO);
+}
+
+static int16_t min16(int16_t a, int16_t b) { return a < b ? a : b; }
+static int16_t max16(int16_t a, int16_t b) { return a > b ? a : b; }
+
+// Paints the pixels of the disc that lie clockwise between the two angles,
+// the wedge must not cross a quarter turn so its bounding box is given by
+// the center and the two arc end points
+static void paint_quadrant_wedge(Canvas* canvas, int16_t radius, int32_t from_angle, int32_t to_angle, GColor8 color)
+{
+    GPoint from = get_arc_point(from_angle, radius);
+    GPoint to = get_arc_point(to_angle, radius);
+    int32_t from_x = sin_lookup(from_angle);
+    int32_t from_y = -cos_lookup(from_angle);
+    int32_t to_x = sin_lookup(to_angle);
+    int32_t to_y = -cos_lookup(to_angle);
+
+    int16_t top = min16(0, min16(from.y, to.y)) - 1;
+    int16_t bottom = max16(0, max16(from.y, to.y)) + 1;
+    int16_t left = min16(0, min16(from.x, to.x)) - 1;
+    int16_t right = max16(0, max16(from.x, to.x)) + 1;
+
+    GPoint c = canvas->center;
+    for(int16_t dy = max16(top, -radius); dy <= min16(bottom, radius); dy++)
+    {
+        int16_t half = get_half_width(radius, dy);
+        int16_t span_start = 0;
+        bool in_span = false;
+        int16_t last = min16(right, half);
+        for(int16_t dx = max16(left, -half); dx <= last; dx++)
+        {
+            // Clockwise of the start ray and counter clockwise of the end ray
+            bool inside = (dx != 0 || dy != 0) &&
+                from_x * dy - from_y * dx >= 0 &&
+                dx * to_y - dy * to_x >= 0;
+            if(inside && !in_span)
+            {
+                span_start = dx;
+                in_span = true;
+            } else if(!inside && in_span)
+            {
+                fill_span(canvas, c.y + dy, c.x + span_start, c.x + dx - 1, color);
+                in_span = false;
+            }
+        }
+        if(in_span)
+        {
+            fill_span(canvas, c.y + dy, c.x + span_start, c.x + last, color);
+        }
+    }
+}
+
+static void paint_wedge(Canvas* canvas, int16_t radius, int32_t from_angle, int32_t to_angle, GColor8 color)
+{
+    while(from_angle < to_angle)
+    {
+        int32_t quadrant_end = (from_angle / QUARTER_TURN + 1) * QUARTER_TURN;
+        int32_t end = quadrant_end < to_angle ? quadrant_end : to_angle;
+        paint_quadrant_wedge(canvas, radius, from_angle, end, color);
+        from_angle = end;
+    }
+}
+
+static void clear_canvas(Canvas* canvas)
+{
+    GRect clip = canvas->clip;
+    for(int16_t y = clip.origin.y; y < clip.origin.y + clip.size.h; y++)
+    {
+        fill_span(canvas, y, clip.origin.x, clip.origin.x + clip.size.w - 1, get_background_color());
+    }
+}
+
+static void render_fallback(Layer* layer, GContext* ctx, Shape shape, uint16_t radius, int32_t start_angle)
+{
+    GRect bounds = layer_get_bounds(layer);
+    graphics_context_set_fill_color(ctx, get_background_color());
+    graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+    graphics_context_set_fill_color(ctx, get_foreground_color());
+    if(shape == ShapeCircle)
+    {
+        graphics_fill_circle(ctx, m_center, radius);
+    } else
+    {
+        GRect circle_rect = GRect(m_center.x - radius, m_center.y - radius, radius * 2, radius * 2);
+        graphics_fill_radial(ctx, circle_rect, GOvalScaleModeFillCircle, radius, start_angle, TRIG_MAX_ANGLE);
+    }
+    m_drawn_shape = ShapeNONE;
+}
+
+void setup_breath_renderer(GPoint center, GPoint screen_offset)
+{
+    m_center = center;
+    m_screen_offset = screen_offset;
+    invalidate_breath_renderer();
+}
+
+void invalidate_breath_renderer()
+{
+    m_drawn_shape = ShapeNONE;
+}
+
+void render_breath_circle(Layer* layer, GContext* ctx, uint16_t radius)
+{
+    Canvas canvas;
+    if(!begin_canvas(&canvas, layer, ctx))
+    {
+        render_fallback(layer, ctx, ShapeCircle, radius, 0);
+        return;
+    }
+
+    if(m_drawn_shape != ShapeCircle)
+    {
+        clear_canvas(&canvas);
+        paint_ring(&canvas, -1, radius, get_foreground_color());
+    } else if(radius > m_drawn_radius)
+    {
+        paint_ring(&canvas, m_drawn_radius, radius, get_foreground_color());
+    } else if(radius < m_drawn_radius)
+    {
+        paint_ring(&canvas, radius, m_drawn_radius, get_background_color());
+    }
+
+    end_canvas(&canvas, ctx);
+    m_drawn_shape = ShapeCircle;
+    m_drawn_radius = radius;
+}
+
+void render_hold_arc(Layer* layer, GContext* ctx, uint16_t radius, int32_t start_angle)
+{
+    Canvas canvas;
+    if(!begin_canvas(&canvas, layer, ctx))
+    {
+        render_fallback(layer, ctx, ShapeArc, radius, start_angle);
+        return;
+    }
+
+    int32_t cleared_from = 0;
+    if(m_drawn_shape != ShapeArc || m_drawn_radius != radius || start_angle < m_drawn_angle)
+    {
+        clear_canvas(&canvas);
+        paint_ring(&canvas, -1, radius, get_foreground_color());
+    } else
+    {
+        cleared_from = m_drawn_angle;
+    }
+
+    if(start_angle >= TRIG_MAX_ANGLE)
+    {
+        paint_ring(&canvas, -1, radius, get_background_color());
+    } else
+    {
+        paint_wedge(&canvas, radius, cleared_from, start_angle, get_background_color());
+    }
+
+    end_canvas(&canvas, ctx);
+    m_drawn_shape = ShapeArc;
+    m_drawn_radius = radius;
+    m_drawn_angle = start_angle;
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <pebble.h>
+
+void setup_breath_renderer(GPoint center, GPoint screen_offset);
+void invalidate_breath_renderer();
+void render_breath_circle(Layer* layer, GContext* ctx, uint16_t radius);
+void render_hold_arc(Layer* layer, GContext* ctx, uint16_t radius, int32_t start_angle);
\ No newline at end of file
@@ -3,4 +3,6 @@
 #include <pebble.h>
 
 void setup_config_menu_window();
+// Applies changed settings when the config window is showing
+void refresh_config_menu_window();
 void tear_down_config_menu_window();
\ No newline at end of file
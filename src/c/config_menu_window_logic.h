@@ -3,21 +3,10 @@
 #include <pebble.h>
 
 void update_config_menu(Window* config_window);
-void setup_settings_items(
-    SimpleMenuItem* theme_item,
-    SimpleMenuItem* short_time,
-    SimpleMenuItem* long_time,
-    SimpleMenuItem* auto_start,
-    SimpleMenuItem* auto_kill,
-    SimpleMenuLayer* settings_menu_layer,
-    StatusBarLayer* status_bar);
-char* get_current_theme();
-char* get_current_short_time();
-char* get_current_long_time();
-char* get_current_auto_start();
-char* get_current_auto_kill();
-void handle_toggle_current_theme(int index, void* context);
-void handle_tick_short_time(int index, void* context);
-void handle_tick_long_time(int index, void* context);
-void handle_toggle_auto_start(int index, void* context);
-void handle_toggle_auto_kill(int index, void* context);
\ No newline at end of file
+void setup_settings_menu(Window* config_window, MenuLayer* settings_menu_layer, StatusBarLayer* status_bar);
+
+uint16_t get_settings_row_count(MenuLayer* menu_layer, uint16_t section_index, void* context);
+int16_t get_settings_header_height(MenuLayer* menu_layer, uint16_t section_index, void* context);
+void draw_settings_header(GContext* ctx, const Layer* cell_layer, uint16_t section_index, void* context);
+void draw_settings_row(GContext* ctx, const Layer* cell_layer, MenuIndex* cell_index, void* context);
+void handle_settings_select(MenuLayer* menu_layer, MenuIndex* cell_index, void* context);
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "custom_exercise.h"
+
+#ifdef BREATH_WORKER
+#include <pebble_worker.h>
+#else
+#include <pebble.h>
+#endif
+
+// The chunk the running program is in, only one custom program runs at a
+// time so a single cache is shared by every cursor
+static ProgramInstruction m_chunk[CUSTOM_CHUNK_INSTRUCTIONS];
+static int16_t m_chunk_index = -1;
+static uint16_t m_length = 0;
+
+bool read_custom_exercise_header(CustomExerciseHeader* header)
+{
+    return persist_read_data(CUSTOM_EXERCISE_HEADER_KEY, header, sizeof(CustomExerciseHeader)) == sizeof(CustomExerciseHeader)
+        && header->version == CUSTOM_EXERCISE_VERSION
+        && header->length <= MAX_CUSTOM_INSTRUCTIONS
+        && header->stored <= header->length;
+}
+
+void copy_custom_exercise_name(char* dest, size_t size, const char* name, size_t length)
+{
+    snprintf(dest, size, "%.*s", (int)length, name);
+    size_t end = strlen(dest);
+    size_t start = end;
+    while(start > 0 && ((uint8_t)dest[start - 1] & 0xC0) == 0x80)
+    {
+        start--;
+    }
+    if(start == 0)
+    {
+        dest[0] = '\0';
+        return;
+    }
+    // The lead byte tells how many bytes its character needs
+    uint8_t lead = dest[start - 1];
+    size_t needed = lead < 0x80 ? 1 : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : 2;
+    if(start - 1 + needed > end)
+    {
+        dest[start - 1] = '\0';
+    }
+}
+
+bool has_custom_exercise()
+{
+    CustomExerciseHeader header;
+    return read_custom_exercise_header(&header) && header.complete;
+}
+
+static const ProgramInstruction* fetch_custom_instruction(uint16_t pc)
+{
+    if(pc >= m_length)
+    {
+        return NULL;
+    }
+    int16_t chunk = pc / CUSTOM_CHUNK_INSTRUCTIONS;
+    if(chunk != m_chunk_index)
+    {
+        // A loop across a chunk boundary reads both chunks every round
+        if(persist_read_data(CUSTOM_EXERCISE_FIRST_CHUNK_KEY + chunk, m_chunk, sizeof(m_chunk)) <= 0)
+        {
+            m_chunk_index = -1;
+            return NULL;
+        }
+        m_chunk_index = chunk;
+    }
+    return &m_chunk[pc % CUSTOM_CHUNK_INSTRUCTIONS];
+}
+
+void start_custom_program(ProgramCursor* cursor, uint8_t quad_time)
+{
+    CustomExerciseHeader header;
+    invalidate_custom_program();
+    m_length = read_custom_exercise_header(&header) && header.complete ? header.length : 0;
+    start_streamed_program(cursor, fetch_custom_instruction, quad_time);
+}
+
+void invalidate_custom_program()
+{
+    m_chunk_index = -1;
+}
\ No newline at end of file
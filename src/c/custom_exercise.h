@@ -0,0 +1,45 @@
+#pragma once
+
+// Shared by the app and the background worker. A custom exercise from the
+// phone is a program of any length kept in persistent storage, the header
+// key describes it and the instructions follow in chunk keys. Sessions
+// read it one chunk at a time, so RAM use does not grow with its length.
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "exercise_program.h"
+
+#define CUSTOM_EXERCISE_HEADER_KEY (659172)
+#define CUSTOM_EXERCISE_FIRST_CHUNK_KEY (659180)
+#define CUSTOM_EXERCISE_VERSION (1)
+
+// Exercise index that selects the custom exercise, the highest value the
+// packed 5 bit index can hold
+#define CUSTOM_EXERCISE_INDEX (31)
+
+#define CUSTOM_EXERCISE_NAME_LENGTH (16)
+// A chunk fills one 256 byte persist value
+#define CUSTOM_CHUNK_INSTRUCTIONS (128)
+// 2 KB, half of the app's persistent storage
+#define MAX_CUSTOM_CHUNKS (8)
+#define MAX_CUSTOM_INSTRUCTIONS (CUSTOM_CHUNK_INSTRUCTIONS * MAX_CUSTOM_CHUNKS)
+
+typedef struct __attribute__((__packed__)) {
+    uint8_t version;
+    // Set once every instruction is stored
+    uint8_t complete;
+    uint16_t length;
+    // Instructions in the chunk keys so far, an interrupted upload resumes here
+    uint16_t stored;
+    uint32_t upload_id;
+    char name[CUSTOM_EXERCISE_NAME_LENGTH];
+} CustomExerciseHeader;
+
+bool read_custom_exercise_header(CustomExerciseHeader* header);
+// Copies at most length bytes of name, cut back to a whole UTF-8
+// character so it fits size with its terminator
+void copy_custom_exercise_name(char* dest, size_t size, const char* name, size_t length);
+bool has_custom_exercise();
+void start_custom_program(ProgramCursor* cursor, uint8_t quad_time);
+// Drops the cached chunk after the stored exercise has been rewritten
+void invalidate_custom_program();
\ No newline at end of file
@@ -4,8 +4,29 @@
 #include <stdbool.h>
 #include <pebble.h>
 
-#define CURRENT_DATA_VERSION (1)
+#define CURRENT_DATA_VERSION (6)
+#define BATTERY_THRESHOLD_STEP (10)
+#define MAX_BATTERY_THRESHOLD (50)
+#define NO_REMINDER (0xFF)
 
+// In RAM form of the settings, never written to flash as is
+typedef struct {
+    GColor8 background_color;
+    GColor8 foreground_color;
+    uint8_t short_quad_time;
+    uint8_t long_quad_time;
+    bool current_is_long;
+    bool auto_start;
+    bool auto_kill;
+    uint8_t exercise_index;
+    bool haptic_only;
+    uint8_t backlight_mode;
+    uint8_t reduced_battery_threshold;
+    uint8_t minimal_battery_threshold;
+    uint8_t reminder_hour;
+} Data;
+
+// Version 1 flash layout, stored under LEGACY_DATA_KEY
 typedef struct {
     GColor8 background_color;
     GColor8 foreground_color;
@@ -15,4 +36,27 @@ typedef struct {
     uint8_t data_version;
     bool auto_start;
     bool auto_kill;
-} Data;
\ No newline at end of file
+} DataV1;
+
+// Version 2+ flash layout, stored under DATA_KEY. New settings take bits
+// from the reserved fields so the blob does not grow, version is always
+// the first byte so any later layout can be recognized.
+typedef struct __attribute__((__packed__)) {
+    uint8_t data_version;
+    uint8_t short_quad_time : 6;
+    uint8_t current_is_long : 1;
+    uint8_t dark_theme : 1;
+    uint8_t long_quad_time : 6;
+    uint8_t auto_start : 1;
+    uint8_t auto_kill : 1;
+    uint8_t exercise_index : 5;
+    uint8_t haptic_only : 1;
+    uint8_t backlight_mode : 2;
+    // Battery percentages in steps of BATTERY_THRESHOLD_STEP
+    uint8_t reduced_battery_threshold : 4;
+    uint8_t minimal_battery_threshold : 4;
+    // Hour of the daily reminder plus one, 0 when there is none
+    uint8_t reminder : 5;
+    uint8_t reserved_bits : 3;
+    uint8_t reserved[2];
+} PersistedData;
\ No newline at end of file
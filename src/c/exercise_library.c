@@ -0,0 +1,63 @@
+#include "exercise_library.h"
+
+#define LOG_MODULE_LEVEL LOG_LEVEL_LIBRARY
+#include "log.h"
+
+#define LIBRARY_VERSION (1)
+
+// Layout is documented in tools/build_exercise_library.py
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t count;
+    uint8_t record_size;
+    uint8_t reserved;
+} LibraryHeader;
+
+static ResHandle m_library = NULL;
+static LibraryHeader m_header;
+static bool m_header_loaded = false;
+
+static bool load_header()
+{
+    if(!m_header_loaded)
+    {
+        m_library = resource_get_handle(RESOURCE_ID_EXERCISE_LIBRARY);
+        size_t read = resource_load_byte_range(m_library, 0, (uint8_t*)&m_header, sizeof(LibraryHeader));
+        if(read != sizeof(LibraryHeader) ||
+            memcmp(m_header.magic, "BRTH", sizeof(m_header.magic)) != 0 ||
+            m_header.version != LIBRARY_VERSION)
+        {
+            LOG_ERROR("Invalid exercise library");
+            m_header.count = 0;
+        }
+        m_header_loaded = true;
+    }
+    return m_header.count > 0;
+}
+
+uint8_t get_exercise_count()
+{
+    return load_header() ? m_header.count : 0;
+}
+
+bool load_exercise(uint8_t index, Exercise* exercise)
+{
+    if(!load_header() || index >= m_header.count)
+    {
+        return false;
+    }
+
+    // Records are fixed size so the selected one is a single read
+    size_t size = m_header.record_size < sizeof(Exercise) ? m_header.record_size : sizeof(Exercise);
+    uint32_t offset = sizeof(LibraryHeader) + (uint32_t)index * m_header.record_size;
+    memset(exercise, 0, sizeof(Exercise));
+    if(resource_load_byte_range(m_library, offset, (uint8_t*)exercise, size) != size)
+    {
+        return false;
+    }
+
+    exercise->name[EXERCISE_NAME_LENGTH - 1] = '\0';
+    exercise->program[MAX_EXERCISE_INSTRUCTIONS - 1] = (ProgramInstruction)PROGRAM_END;
+    return true;
+}
\ No newline at end of file
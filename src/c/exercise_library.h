@@ -0,0 +1,15 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "exercise_program.h"
+
+#define EXERCISE_NAME_LENGTH (16)
+
+typedef struct {
+    char name[EXERCISE_NAME_LENGTH];
+    ProgramInstruction program[MAX_EXERCISE_INSTRUCTIONS];
+} Exercise;
+
+uint8_t get_exercise_count();
+bool load_exercise(uint8_t index, Exercise* exercise);
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "exercise_program.h"
+
+#define OP_MASK (0x03)
+#define TYPE_SHIFT (2)
+#define TYPE_MASK (0x07)
+#define ORIFICE_SHIFT (5)
+#define ORIFICE_MASK (0x03)
+
+void start_program(ProgramCursor* cursor, const ProgramInstruction* program, uint8_t quad_time)
+{
+    cursor->program = program;
+    cursor->fetch = NULL;
+    cursor->quad_time = quad_time;
+    cursor->pc = 0;
+    cursor->loop_start = 0;
+    cursor->loop_remaining = 0;
+}
+
+void start_streamed_program(ProgramCursor* cursor, ProgramFetch fetch, uint8_t quad_time)
+{
+    start_program(cursor, NULL, quad_time);
+    cursor->fetch = fetch;
+}
+
+static ProgramInstruction read_instruction(const ProgramCursor* cursor, uint16_t pc)
+{
+    if(cursor->fetch == NULL)
+    {
+        return cursor->program[pc];
+    }
+    const ProgramInstruction* instruction = cursor->fetch(pc);
+    return instruction != NULL ? *instruction : (ProgramInstruction)PROGRAM_END;
+}
+
+static uint32_t get_beats_ms(uint8_t beats, uint8_t quad_time)
+{
+    return ((uint32_t)beats * quad_time * 100) / BEATS_PER_QUAD;
+}
+
+bool next_program_action(ProgramCursor* cursor, Action* action)
+{
+    while(true)
+    {
+        ProgramInstruction instruction = read_instruction(cursor, cursor->pc++);
+        switch(instruction.code & OP_MASK)
+        {
+            case OpPhase:
+                action->type = (instruction.code >> TYPE_SHIFT) & TYPE_MASK;
+                action->orifice = (instruction.code >> ORIFICE_SHIFT) & ORIFICE_MASK;
+                action->duration_ms = get_beats_ms(instruction.value, cursor->quad_time);
+                return true;
+            case OpLoop:
+                cursor->loop_start = cursor->pc;
+                cursor->loop_remaining = instruction.value > 0 ? instruction.value - 1 : 0;
+                break;
+            case OpEndLoop:
+                if(cursor->loop_remaining > 0)
+                {
+                    cursor->loop_remaining--;
+                    cursor->pc = cursor->loop_start;
+                }
+                break;
+            case OpEnd:
+            default:
+                cursor->pc--;
+                return false;
+        }
+    }
+}
+
+uint32_t get_program_duration_ms(const ProgramCursor* start)
+{
+    ProgramCursor cursor = *start;
+    Action action;
+    uint32_t duration_ms = 0;
+    while(next_program_action(&cursor, &action))
+    {
+        duration_ms += action.duration_ms;
+    }
+    return duration_ms;
+}
\ No newline at end of file
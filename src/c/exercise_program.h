@@ -0,0 +1,73 @@
+#pragma once
+
+// Also built into the background worker, so only plain C headers here
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum {
+    OrificeNONE,
+    Mouth,
+    Nose,
+} Orifice;
+
+typedef enum {
+    ActionTypeNONE,
+    BreatheIn,
+    BreatheOut,
+    HoldFullBreath,
+    HoldEmptyBreath,
+} ActionType;
+
+typedef struct {
+    uint32_t duration_ms;
+    Orifice orifice;
+    ActionType type;
+} Action;
+
+typedef enum {
+    OpEnd,
+    OpPhase,
+    OpLoop,
+    OpEndLoop,
+} ProgramOp;
+
+// Two bytes per instruction, the code byte packs the op in bits 0-1, the
+// action type in bits 2-4 and the orifice in bits 5-6. The value byte is
+// the phase length in beats, or the number of rounds for OpLoop.
+typedef struct {
+    uint8_t code;
+    uint8_t value;
+} ProgramInstruction;
+
+#define PROGRAM_PHASE(type, orifice, beats) { OpPhase | ((type) << 2) | ((orifice) << 5), (beats) }
+#define PROGRAM_LOOP(rounds) { OpLoop, (rounds) }
+#define PROGRAM_END_LOOP { OpEndLoop, 0 }
+#define PROGRAM_END { OpEnd, 0 }
+
+// Longest program an exercise or a handed off session can hold
+#define MAX_EXERCISE_INSTRUCTIONS (24)
+
+// One beat is a quarter of the quad time, quad time is in tenths of a second
+#define BEATS_PER_QUAD (4)
+
+// Returns the instruction at pc of a program that is not held in RAM, or
+// NULL past its end
+typedef const ProgramInstruction* (*ProgramFetch)(uint16_t pc);
+
+// Interpreter state, loops can not be nested. A program is either an
+// array or read through fetch one instruction at a time.
+typedef struct {
+    const ProgramInstruction* program;
+    ProgramFetch fetch;
+    uint8_t quad_time;
+    uint8_t loop_remaining;
+    uint16_t pc;
+    uint16_t loop_start;
+} ProgramCursor;
+
+void start_program(ProgramCursor* cursor, const ProgramInstruction* program, uint8_t quad_time);
+void start_streamed_program(ProgramCursor* cursor, ProgramFetch fetch, uint8_t quad_time);
+bool next_program_action(ProgramCursor* cursor, Action* action);
+// Time from the cursor to the end of the program, the cursor is not moved
+uint32_t get_program_duration_ms(const ProgramCursor* start);
\ No newline at end of file
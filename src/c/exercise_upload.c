@@ -0,0 +1,148 @@
+#include "exercise_upload.h"
+
+#include "phone_link.h"
+
+#define LOG_MODULE_LEVEL LOG_LEVEL_PHONE_LINK
+#include "log.h"
+
+// The phone starts an upload with its id, length and name and then sends
+// the instructions in order, a few data messages ahead of the last ack.
+// Every ack is the offset of the next instruction the watch needs, so a
+// message after a lost one is answered with the offset to go back to and
+// acks that could not be sent yet are replaced by the newest one.
+//
+// Received instructions are collected in m_chunk and written when it is
+// full, the header's stored count moves with every written chunk. When an
+// upload with the same id starts again, after a lost connection or with
+// the app closed in between, it is acked from the stored count.
+#define UPLOAD_REJECTED (-1)
+#define DEFAULT_CUSTOM_EXERCISE_NAME "Custom"
+
+static CustomExerciseHeader m_header;
+static bool m_uploading = false;
+static uint16_t m_received = 0;
+static ProgramInstruction m_chunk[CUSTOM_CHUNK_INSTRUCTIONS];
+
+static bool m_ack_pending = false;
+static uint32_t m_ack_upload_id;
+static int32_t m_ack;
+
+static void queue_ack(uint32_t upload_id, int32_t ack)
+{
+    m_ack_upload_id = upload_id;
+    m_ack = ack;
+    m_ack_pending = true;
+}
+
+static void store_chunk()
+{
+    uint16_t chunk = (m_received - 1) / CUSTOM_CHUNK_INSTRUCTIONS;
+    uint16_t count = m_received - chunk * CUSTOM_CHUNK_INSTRUCTIONS;
+    persist_write_data(CUSTOM_EXERCISE_FIRST_CHUNK_KEY + chunk, m_chunk, count * sizeof(ProgramInstruction));
+    m_header.stored = m_received;
+    m_header.complete = m_received == m_header.length;
+    persist_write_data(CUSTOM_EXERCISE_HEADER_KEY, &m_header, sizeof(CustomExerciseHeader));
+}
+
+static UploadEvent start_upload(uint32_t upload_id, int32_t length, const Tuple* name)
+{
+    if(length <= 0 || length > MAX_CUSTOM_INSTRUCTIONS)
+    {
+        LOG_WARNING("Rejecting a custom exercise of %d instructions", (int)length);
+        m_uploading = false;
+        queue_ack(upload_id, UPLOAD_REJECTED);
+        return UploadEventProgress;
+    }
+
+    UploadEvent event = UploadEventProgress;
+    if(!read_custom_exercise_header(&m_header) || m_header.upload_id != upload_id || m_header.length != length)
+    {
+        // The old exercise is gone as soon as the new header is written
+        memset(&m_header, 0, sizeof(CustomExerciseHeader));
+        m_header.version = CUSTOM_EXERCISE_VERSION;
+        m_header.length = length;
+        m_header.upload_id = upload_id;
+        const char* text = name != NULL && name->type == TUPLE_CSTRING ? name->value->cstring : DEFAULT_CUSTOM_EXERCISE_NAME;
+        copy_custom_exercise_name(m_header.name, sizeof(m_header.name), text, strlen(text));
+        persist_write_data(CUSTOM_EXERCISE_HEADER_KEY, &m_header, sizeof(CustomExerciseHeader));
+        event = UploadEventExerciseChanged;
+    }
+    m_received = m_header.stored;
+    m_uploading = !m_header.complete;
+    LOG_INFO("Custom exercise upload %u at %d of %d", (unsigned)upload_id, m_received, m_header.length);
+    queue_ack(upload_id, m_received);
+    return event;
+}
+
+static UploadEvent receive_data(uint32_t upload_id, int32_t offset, const Tuple* data)
+{
+    if(!m_uploading || upload_id != m_header.upload_id)
+    {
+        // The phone starts over when its acks stop coming
+        LOG_DEBUG("Ignoring data of upload %u", (unsigned)upload_id);
+        return UploadEventProgress;
+    }
+    if(offset != m_received || data == NULL || data->type != TUPLE_BYTE_ARRAY)
+    {
+        // A message after a lost one, or one that was sent again
+        queue_ack(upload_id, m_received);
+        return UploadEventProgress;
+    }
+
+    const ProgramInstruction* instructions = (const ProgramInstruction*)data->value->data;
+    uint16_t count = data->length / sizeof(ProgramInstruction);
+    if(count > m_header.length - m_received)
+    {
+        count = m_header.length - m_received;
+    }
+    for(uint16_t i = 0; i < count; i++)
+    {
+        m_chunk[m_received % CUSTOM_CHUNK_INSTRUCTIONS] = instructions[i];
+        m_received++;
+        if(m_received % CUSTOM_CHUNK_INSTRUCTIONS == 0 || m_received == m_header.length)
+        {
+            store_chunk();
+        }
+    }
+    queue_ack(upload_id, m_received);
+
+    if(m_header.complete)
+    {
+        LOG_INFO("Stored custom exercise %s", m_header.name);
+        m_uploading = false;
+        return UploadEventExerciseChanged;
+    }
+    return UploadEventProgress;
+}
+
+UploadEvent handle_upload_message(DictionaryIterator* iterator)
+{
+    Tuple* upload_id = dict_find(iterator, MESSAGE_KEY_UploadId);
+    if(upload_id == NULL)
+    {
+        return UploadEventNONE;
+    }
+    Tuple* length = dict_find(iterator, MESSAGE_KEY_UploadLength);
+    if(length != NULL)
+    {
+        return start_upload(get_tuple_int(upload_id), get_tuple_int(length), dict_find(iterator, MESSAGE_KEY_UploadName));
+    }
+    Tuple* offset = dict_find(iterator, MESSAGE_KEY_UploadOffset);
+    if(offset != NULL)
+    {
+        return receive_data(get_tuple_int(upload_id), get_tuple_int(offset), dict_find(iterator, MESSAGE_KEY_UploadData));
+    }
+    return UploadEventProgress;
+}
+
+bool has_upload_ack()
+{
+    return m_ack_pending;
+}
+
+void write_upload_ack(DictionaryIterator* iterator)
+{
+    dict_write_int32(iterator, MESSAGE_KEY_UploadId, m_ack_upload_id);
+    dict_write_int32(iterator, MESSAGE_KEY_UploadAck, m_ack);
+    m_ack_pending = false;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "custom_exercise.h"
+
+// Instructions in one data message, a quarter of a storage chunk
+#define UPLOAD_DATA_INSTRUCTIONS (32)
+// A data message carries the upload id, its offset and the instructions,
+// the start message the id, the length and the name
+#define UPLOAD_MESSAGE_SIZE (1 + 2 * (7 + sizeof(int32_t)) + 7 + UPLOAD_DATA_INSTRUCTIONS * sizeof(ProgramInstruction))
+
+typedef enum {
+    UploadEventNONE,
+    UploadEventProgress,
+    // The stored custom exercise was replaced or finished
+    UploadEventExerciseChanged,
+} UploadEvent;
+
+// Returns UploadEventNONE for messages that are not part of an upload
+UploadEvent handle_upload_message(DictionaryIterator* iterator);
+bool has_upload_ack();
+void write_upload_ack(DictionaryIterator* iterator);
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+
+// Vibe segments for haptic guidance, shared by the app and the background
+// worker. Each action gets a pattern of its own: rising for in, falling
+// for out, short taps for holds.
+static const uint32_t BREATHE_IN_SEGMENTS[] = { 40, 60, 40, 60, 200 };
+static const uint32_t BREATHE_OUT_SEGMENTS[] = { 200, 60, 40, 60, 40 };
+static const uint32_t HOLD_FULL_BREATH_SEGMENTS[] = { 40, 80, 40 };
+static const uint32_t HOLD_EMPTY_BREATH_SEGMENTS[] = { 40 };
+static const uint32_t SESSION_END_SEGMENTS[] = { 400 };
+
+#define VIBE_PATTERN(segments_array) { .durations = segments_array, .num_segments = sizeof(segments_array) / sizeof((segments_array)[0]) }
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "heap_tracker.h"
+
+#ifdef BREATH_PROFILING
+
+#include "log.h"
+
+// Enough for both windows, their layers and the icon cache
+#define MAX_TRACKED_OBJECTS (32)
+
+typedef struct {
+    size_t live_bytes;
+    size_t peak_bytes;
+    uint16_t live_count;
+    uint16_t allocations;
+} HeapTagStats;
+
+typedef struct {
+    void* object;
+    uint16_t size;
+    uint8_t tag;
+} TrackedObject;
+
+static const char* const HEAP_TAG_NAMES[HeapTagCOUNT] =
+{
+    [HeapTagWindows] = "windows",
+    [HeapTagLayers] = "layers",
+    [HeapTagIcons] = "icons",
+};
+
+static HeapTagStats m_tags[HeapTagCOUNT];
+static TrackedObject m_objects[MAX_TRACKED_OBJECTS];
+static size_t m_live_bytes = 0;
+static size_t m_peak_bytes = 0;
+static size_t m_used_before_create = 0;
+static bool m_over_budget = false;
+
+void heap_track_begin()
+{
+    m_used_before_create = heap_bytes_used();
+}
+
+static TrackedObject* find_tracked_object(const void* object)
+{
+    for(uint8_t i = 0; i < MAX_TRACKED_OBJECTS; i++)
+    {
+        if(m_objects[i].object == object)
+        {
+            return &m_objects[i];
+        }
+    }
+    return NULL;
+}
+
+static void check_budget()
+{
+    // Warns once per crossing, not on every object above it
+    if(!m_over_budget && m_live_bytes > HEAP_BUDGET_BYTES)
+    {
+        LOG_WARNING("heap: %u tracked bytes over the %u byte budget", (unsigned)m_live_bytes, (unsigned)HEAP_BUDGET_BYTES);
+    }
+    m_over_budget = m_live_bytes > HEAP_BUDGET_BYTES;
+}
+
+void* heap_track_end(HeapTag tag, void* object)
+{
+    size_t used = heap_bytes_used();
+    size_t size = used > m_used_before_create ? used - m_used_before_create : 0;
+    if(object == NULL)
+    {
+        return NULL;
+    }
+    TrackedObject* tracked = find_tracked_object(NULL);
+    if(tracked == NULL)
+    {
+        LOG_WARNING("heap: no room to track a %u byte %s object", (unsigned)size, HEAP_TAG_NAMES[tag]);
+        return object;
+    }
+    *tracked = (TrackedObject) { .object = object, .size = size, .tag = tag };
+
+    HeapTagStats* stats = &m_tags[tag];
+    stats->live_bytes += size;
+    stats->live_count++;
+    stats->allocations++;
+    if(stats->live_bytes > stats->peak_bytes)
+    {
+        stats->peak_bytes = stats->live_bytes;
+    }
+    m_live_bytes += size;
+    if(m_live_bytes > m_peak_bytes)
+    {
+        m_peak_bytes = m_live_bytes;
+    }
+    check_budget();
+    return object;
+}
+
+void heap_track_free(void* object)
+{
+    TrackedObject* tracked = object != NULL ? find_tracked_object(object) : NULL;
+    if(tracked == NULL)
+    {
+        return;
+    }
+    HeapTagStats* stats = &m_tags[tracked->tag];
+    stats->live_bytes -= tracked->size;
+    stats->live_count--;
+    m_live_bytes -= tracked->size;
+    tracked->object = NULL;
+    check_budget();
+}
+
+size_t get_tracked_heap_live_bytes()
+{
+    return m_live_bytes;
+}
+
+size_t get_tracked_heap_peak_bytes()
+{
+    return m_peak_bytes;
+}
+
+void format_heap_report(char* text, size_t size)
+{
+    snprintf(text, size, "heap %u/%uB w%u l%u i%u",
+        (unsigned)m_live_bytes, (unsigned)m_peak_bytes,
+        (unsigned)m_tags[HeapTagWindows].live_bytes,
+        (unsigned)m_tags[HeapTagLayers].live_bytes,
+        (unsigned)m_tags[HeapTagIcons].live_bytes);
+}
+
+void log_heap_report()
+{
+    for(uint8_t tag = 0; tag < HeapTagCOUNT; tag++)
+    {
+        const HeapTagStats* stats = &m_tags[tag];
+        LOG_INFO("heap: %s live %uB in %u objects, peak %uB, %u created",
+            HEAP_TAG_NAMES[tag], (unsigned)stats->live_bytes, stats->live_count,
+            (unsigned)stats->peak_bytes, stats->allocations);
+    }
+    LOG_INFO("heap: tracked live %uB peak %uB, budget %uB, heap used %u free %u",
+        (unsigned)m_live_bytes, (unsigned)m_peak_bytes, (unsigned)HEAP_BUDGET_BYTES,
+        (unsigned)heap_bytes_used(), (unsigned)heap_bytes_free());
+    for(uint8_t i = 0; i < MAX_TRACKED_OBJECTS; i++)
+    {
+        if(m_objects[i].object != NULL)
+        {
+            LOG_WARNING("heap: leaked %u byte %s object", m_objects[i].size, HEAP_TAG_NAMES[m_objects[i].tag]);
+        }
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <pebble.h>
+
+// Heap accounting for the objects the app creates, only built when
+// BREATH_PROFILING is defined. Wrap a *_create call in TRACK_CREATE with
+// the tag of the part that owns it and its *_destroy call in
+// TRACK_DESTROY. The size of an object is how much the heap grew while it
+// was created, so it includes whatever the SDK allocated along with it.
+
+typedef enum {
+    HeapTagWindows,
+    HeapTagLayers,
+    HeapTagIcons,
+    HeapTagCOUNT,
+} HeapTag;
+
+#ifdef BREATH_PROFILING
+
+// Tracked bytes above which a warning is logged, override from the build
+// e.g. -DHEAP_BUDGET_BYTES=4096
+#ifndef HEAP_BUDGET_BYTES
+#define HEAP_BUDGET_BYTES PBL_IF_COLOR_ELSE(12288, 6144)
+#endif
+
+void heap_track_begin();
+void* heap_track_end(HeapTag tag, void* object);
+void heap_track_free(void* object);
+size_t get_tracked_heap_live_bytes();
+size_t get_tracked_heap_peak_bytes();
+void format_heap_report(char* text, size_t size);
+// Logs every tag and warns about objects that are still live
+void log_heap_report();
+
+#define TRACK_CREATE(tag, create) (heap_track_begin(), heap_track_end(tag, create))
+#define TRACK_DESTROY(destroy, object) (heap_track_free(object), destroy(object))
+#define HEAP_REPORT() log_heap_report()
+
+#else
+
+#define TRACK_CREATE(tag, create) (create)
+#define TRACK_DESTROY(destroy, object) destroy(object)
+#define HEAP_REPORT()
+
+#endif
\ No newline at end of file
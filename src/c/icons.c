@@ -1,93 +1,173 @@
 #include "icons.h"
 
 #include "persistance.h"
+#include "heap_tracker.h"
 
-static GBitmap *config_icon;
-static GBitmap *play_icon;
-static GBitmap *breath_icon;
-static GBitmap *pause_icon;
-static GBitmap *swap_icon;
+// Bitmaps are cached by resource id and shared by everyone showing them.
+// An entry that nobody holds any more is kept until invalidate_icons or
+// destroy_all_icons, the action bar may still be animating it out.
+#define ICON_CACHE_SIZE (8)
 
-static GBitmap* get_icon(uint32_t id, GBitmap* icon)
+typedef struct {
+    uint32_t resource_id;
+    GBitmap* bitmap;
+    uint8_t refs;
+} IconCacheEntry;
+
+static IconCacheEntry m_cache[ICON_CACHE_SIZE];
+
+#ifdef PBL_COLOR
+// Color platforms ship one bitmap per icon and paint it in the theme color
+static GColor8 m_icon_color;
+
+static uint8_t get_palette_size(GBitmapFormat format)
 {
-    if(icon == NULL)
+    switch (format)
     {
-        icon = gbitmap_create_with_resource(id);
+        case GBitmapFormat1BitPalette:
+            return 2;
+        case GBitmapFormat2BitPalette:
+            return 4;
+        case GBitmapFormat4BitPalette:
+            return 16;
+        default:
+            return 0;
     }
+}
 
-    return icon;
+static void recolor_icon(GBitmap* bitmap, GColor8 color)
+{
+    uint8_t size = get_palette_size(gbitmap_get_format(bitmap));
+    if(size == 0)
+    {
+        // Not palettized, there are no colors to swap
+        return;
+    }
+    GColor* palette = gbitmap_get_palette(bitmap);
+    for(uint8_t i = 0; i < size; i++)
+    {
+        // Keep the alpha so transparent and anti aliased pixels stay as they are
+        palette[i].argb = (palette[i].argb & 0xC0) | (color.argb & 0x3F);
+    }
+    gbitmap_set_palette(bitmap, palette, false);
 }
 
-static void destroy_icon(GBitmap* icon)
+#define THEMED_ICON(color_id, black_id, white_id) (color_id)
+#else
+#define THEMED_ICON(color_id, black_id, white_id) (is_dark_theme() ? (black_id) : (white_id))
+#endif
+
+static GBitmap* get_icon(uint32_t id)
 {
-    if(icon == NULL)
+    IconCacheEntry* free_entry = NULL;
+    for(uint8_t i = 0; i < ICON_CACHE_SIZE; i++)
+    {
+        if(m_cache[i].bitmap != NULL && m_cache[i].resource_id == id)
+        {
+            m_cache[i].refs++;
+            return m_cache[i].bitmap;
+        }
+        if(free_entry == NULL && m_cache[i].bitmap == NULL)
+        {
+            free_entry = &m_cache[i];
+        }
+    }
+
+    GBitmap* bitmap = TRACK_CREATE(HeapTagIcons, gbitmap_create_with_resource(id));
+    if(bitmap == NULL || free_entry == NULL)
     {
-        gbitmap_destroy(icon);
+        // Not cached, the caller still owns it through release_icon
+        return bitmap;
     }
+#ifdef PBL_COLOR
+    recolor_icon(bitmap, get_background_color());
+#endif
+    free_entry->resource_id = id;
+    free_entry->bitmap = bitmap;
+    free_entry->refs = 1;
+    return bitmap;
 }
 
-GBitmap* get_config_icon()
+void release_icon(GBitmap* icon)
 {
-    uint32_t icon_id;
-    if(is_dark_theme())
+    if(icon == NULL)
     {
-        icon_id = RESOURCE_ID_CONFIG_BLACK_ICON;
-    } else
+        return;
+    }
+    for(uint8_t i = 0; i < ICON_CACHE_SIZE; i++)
     {
-        icon_id = RESOURCE_ID_CONFIG_WHITE_ICON;
+        if(m_cache[i].bitmap == icon)
+        {
+            if(m_cache[i].refs > 0)
+            {
+                m_cache[i].refs--;
+            }
+            return;
+        }
     }
-    return get_icon(icon_id, config_icon);
+    TRACK_DESTROY(gbitmap_destroy, icon);
 }
 
-GBitmap* get_play_icon()
+static void destroy_icon(IconCacheEntry* entry)
 {
-    uint32_t icon_id;
-    if(is_dark_theme())
+    if(entry->bitmap != NULL)
     {
-        icon_id = RESOURCE_ID_PLAY_BLACK_ICON;
-    } else
+        TRACK_DESTROY(gbitmap_destroy, entry->bitmap);
+        entry->bitmap = NULL;
+        entry->refs = 0;
+    }
+}
+
+void invalidate_icons()
+{
+#ifdef PBL_COLOR
+    bool recolor = !gcolor_equal(m_icon_color, get_background_color());
+    m_icon_color = get_background_color();
+#endif
+    for(uint8_t i = 0; i < ICON_CACHE_SIZE; i++)
     {
-        icon_id = RESOURCE_ID_PLAY_WHITE_ICON;
+        if(m_cache[i].refs == 0)
+        {
+            destroy_icon(&m_cache[i]);
+        }
+#ifdef PBL_COLOR
+        else if(recolor)
+        {
+            recolor_icon(m_cache[i].bitmap, m_icon_color);
+        }
+#endif
     }
-    return get_icon(icon_id, play_icon);
+}
+
+GBitmap* get_config_icon()
+{
+    return get_icon(THEMED_ICON(RESOURCE_ID_CONFIG_ICON, RESOURCE_ID_CONFIG_BLACK_ICON, RESOURCE_ID_CONFIG_WHITE_ICON));
+}
+
+GBitmap* get_play_icon()
+{
+    return get_icon(THEMED_ICON(RESOURCE_ID_PLAY_ICON, RESOURCE_ID_PLAY_BLACK_ICON, RESOURCE_ID_PLAY_WHITE_ICON));
 }
 
 GBitmap* get_breath_icon()
 {
-    return get_icon(RESOURCE_ID_BREATH_ICON, breath_icon);
+    return get_icon(RESOURCE_ID_BREATH_ICON);
 }
 
 GBitmap* get_pause_icon()
 {
-    uint32_t icon_id;
-    if(is_dark_theme())
-    {
-        icon_id = RESOURCE_ID_PAUSE_BLACK_ICON;
-    } else
-    {
-        icon_id = RESOURCE_ID_PAUSE_WHITE_ICON;
-    }
-    return get_icon(icon_id, pause_icon);
+    return get_icon(THEMED_ICON(RESOURCE_ID_PAUSE_ICON, RESOURCE_ID_PAUSE_BLACK_ICON, RESOURCE_ID_PAUSE_WHITE_ICON));
 }
 
 GBitmap* get_swap_icon()
 {
-    uint32_t icon_id;
-    if(is_dark_theme())
-    {
-        icon_id = RESOURCE_ID_SWAP_BLACK_ICON;
-    } else
-    {
-        icon_id = RESOURCE_ID_SWAP_WHITE_ICON;
-    }
-    return get_icon(icon_id, swap_icon);
+    return get_icon(THEMED_ICON(RESOURCE_ID_SWAP_ICON, RESOURCE_ID_SWAP_BLACK_ICON, RESOURCE_ID_SWAP_WHITE_ICON));
 }
 
 void destroy_all_icons()
 {
-    destroy_icon(config_icon);
-    destroy_icon(play_icon);
-    destroy_icon(breath_icon);
-    destroy_icon(pause_icon);
-    destroy_icon(swap_icon);
+    for(uint8_t i = 0; i < ICON_CACHE_SIZE; i++)
+    {
+        destroy_icon(&m_cache[i]);
+    }
 }
@@ -2,6 +2,8 @@
 
 #include <pebble.h>
 
+// Each get_*_icon takes a reference on a cached bitmap, hand it back with
+// release_icon when it is no longer shown
 GBitmap* get_check_icon();
 GBitmap* get_config_icon();
 GBitmap* get_edit_icon();
@@ -13,4 +15,9 @@ GBitmap* get_refresh_icon();
 GBitmap* get_pause_icon();
 GBitmap* get_swap_icon();
 
+void release_icon(GBitmap* icon);
+
+// Call when the theme may have changed, recolors the cached icons on color
+// platforms and frees the ones nobody holds
+void invalidate_icons();
 void destroy_all_icons();
\ No newline at end of file
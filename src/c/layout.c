@@ -0,0 +1,79 @@
+#include "layout.h"
+
+// The rectangular sizes were tuned on the 144x168 display and grow with
+// the display height, round displays have their own
+#define SCALE_TO_DISPLAY(size) ((size) * PBL_DISPLAY_HEIGHT / 168)
+
+static const LayoutSpec LAYOUT_SPEC =
+{
+    .min_radius = SCALE_TO_DISPLAY(10),
+    .max_radius = PBL_IF_ROUND_ELSE(46, SCALE_TO_DISPLAY(50)),
+    .circle_offset_x = PBL_IF_ROUND_ELSE(8, -2),
+    .circle_offset_y = PBL_IF_ROUND_ELSE(-8, SCALE_TO_DISPLAY(-10)),
+#if PBL_DISPLAY_HEIGHT >= 228
+    .text_height = 28,
+    .text_font_key = FONT_KEY_GOTHIC_24,
+#else
+    .text_height = 20,
+    .text_font_key = FONT_KEY_GOTHIC_18,
+#endif
+    .text_inset = PBL_IF_ROUND_ELSE(18, 0),
+    .text_bottom_margin = PBL_IF_ROUND_ELSE(14, SCALE_TO_DISPLAY(8)),
+};
+
+static Layout m_layout;
+
+const LayoutSpec* get_layout_spec()
+{
+    return &LAYOUT_SPEC;
+}
+
+const Layout* get_layout()
+{
+    return &m_layout;
+}
+
+static int16_t min_int16(int16_t a, int16_t b)
+{
+    return a < b ? a : b;
+}
+
+bool update_layout(GRect bounds)
+{
+    const LayoutSpec* spec = &LAYOUT_SPEC;
+    Layout layout;
+    memset(&layout, 0, sizeof(Layout));
+
+    layout.main_frame = GRect(
+        bounds.origin.x,
+        bounds.origin.y + STATUS_BAR_LAYER_HEIGHT,
+        bounds.size.w - ACTION_BAR_WIDTH,
+        bounds.size.h - STATUS_BAR_LAYER_HEIGHT);
+    int16_t width = layout.main_frame.size.w;
+    int16_t height = layout.main_frame.size.h;
+
+    layout.text_frame = GRect(
+        spec->text_inset,
+        height - spec->text_height - spec->text_bottom_margin,
+        width - 2 * spec->text_inset,
+        spec->text_height);
+
+    // A quick view peek leaves less height, the circle shrinks to stay
+    // clear of the status bar and the phase text
+    GPoint center = GPoint(width / 2 + spec->circle_offset_x, height / 2 + spec->circle_offset_y);
+    int16_t room = min_int16(center.y, layout.text_frame.origin.y - center.y);
+    layout.max_radius = room > 0 ? min_int16(spec->max_radius, room) : 0;
+    layout.min_radius = min_int16(spec->min_radius, layout.max_radius);
+    layout.circle_frame = GRect(
+        center.x - layout.max_radius,
+        center.y - layout.max_radius,
+        layout.max_radius * 2 + 1,
+        layout.max_radius * 2 + 1);
+
+    if(memcmp(&layout, &m_layout, sizeof(Layout)) == 0)
+    {
+        return false;
+    }
+    m_layout = layout;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <pebble.h>
+
+// Main window geometry for the platform being built, fixed at compile time
+typedef struct {
+    uint8_t min_radius;
+    uint8_t max_radius;
+    // Circle center relative to the center of the area left of the action bar
+    int8_t circle_offset_x;
+    int8_t circle_offset_y;
+    uint8_t text_height;
+    // Keeps the phase text off the curved edge of round displays
+    uint8_t text_inset;
+    uint8_t text_bottom_margin;
+    const char* text_font_key;
+} LayoutSpec;
+
+// Frames resolved from the spec for the current unobstructed area, the
+// circle and text frames are relative to the main frame
+typedef struct {
+    GRect main_frame;
+    GRect circle_frame;
+    GRect text_frame;
+    uint8_t min_radius;
+    uint8_t max_radius;
+} Layout;
+
+const LayoutSpec* get_layout_spec();
+const Layout* get_layout();
+// Resolves the layout for the unobstructed window bounds, returns true
+// when any frame moved
+bool update_layout(GRect bounds);
\ No newline at end of file
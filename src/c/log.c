@@ -0,0 +1,47 @@
+#include "log.h"
+
+#if LOG_TRACE_ENTRIES > 0
+
+typedef struct {
+    const char* fmt;
+    int args[2];
+} TraceEntry;
+
+static TraceEntry m_traces[LOG_TRACE_ENTRIES];
+static uint16_t m_trace_head = 0;
+static uint16_t m_trace_count = 0;
+static uint16_t m_traces_dropped = 0;
+
+void log_trace(const char* fmt, int first, int second)
+{
+    TraceEntry* entry = &m_traces[(m_trace_head + m_trace_count) % LOG_TRACE_ENTRIES];
+    if(m_trace_count < LOG_TRACE_ENTRIES)
+    {
+        m_trace_count++;
+    } else {
+        // Full, the oldest entry is overwritten
+        m_trace_head = (m_trace_head + 1) % LOG_TRACE_ENTRIES;
+        m_traces_dropped++;
+    }
+    entry->fmt = fmt;
+    entry->args[0] = first;
+    entry->args[1] = second;
+}
+
+void flush_traces()
+{
+    if(m_traces_dropped > 0)
+    {
+        APP_LOG(APP_LOG_LEVEL_DEBUG, "%d traces dropped", m_traces_dropped);
+    }
+    for(uint16_t i = 0; i < m_trace_count; i++)
+    {
+        TraceEntry* entry = &m_traces[(m_trace_head + i) % LOG_TRACE_ENTRIES];
+        APP_LOG(APP_LOG_LEVEL_DEBUG, entry->fmt, entry->args[0], entry->args[1]);
+    }
+    m_trace_head = 0;
+    m_trace_count = 0;
+    m_traces_dropped = 0;
+}
+
+#endif
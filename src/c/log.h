@@ -0,0 +1,82 @@
+#pragma once
+
+#include <pebble.h>
+
+// Compile time gated logging. A module picks its level by defining
+// LOG_MODULE_LEVEL before including this header, calls above that level
+// are constant false branches the compiler drops. The module levels below
+// can be overridden from the build, e.g. -DLOG_LEVEL_MAIN_WINDOW=5
+//
+// LOG_TRACE is meant for per frame values. Traces are not sent when they
+// are made, they are stored in a RAM ring and sent in one batch by
+// LOG_FLUSH_TRACES, which the session calls at phase boundaries.
+
+#define LOG_LEVEL_NONE (0)
+#define LOG_LEVEL_ERROR (1)
+#define LOG_LEVEL_WARNING (2)
+#define LOG_LEVEL_INFO (3)
+#define LOG_LEVEL_DEBUG (4)
+#define LOG_LEVEL_TRACE (5)
+
+#ifdef BREATH_PROFILING
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_DEBUG
+#define LOG_TRACE_ENTRIES (32)
+#else
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_INFO
+#define LOG_TRACE_ENTRIES (0)
+#endif
+
+#ifndef LOG_LEVEL_APP
+#define LOG_LEVEL_APP LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_MAIN_WINDOW
+#define LOG_LEVEL_MAIN_WINDOW LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_PERSISTANCE
+#define LOG_LEVEL_PERSISTANCE LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_HISTORY
+#define LOG_LEVEL_HISTORY LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_SESSION_WORKER
+#define LOG_LEVEL_SESSION_WORKER LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_LIBRARY
+#define LOG_LEVEL_LIBRARY LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_SETTINGS_SYNC
+#define LOG_LEVEL_SETTINGS_SYNC LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_PHONE_LINK
+#define LOG_LEVEL_PHONE_LINK LOG_LEVEL_DEFAULT
+#endif
+
+#ifndef LOG_MODULE_LEVEL
+#define LOG_MODULE_LEVEL LOG_LEVEL_DEFAULT
+#endif
+
+#define LOG_AT(level, app_log_level, fmt, args...) \
+    do { if(LOG_MODULE_LEVEL >= (level)) APP_LOG(app_log_level, fmt, ## args); } while(0)
+
+#define LOG_ERROR(fmt, args...) LOG_AT(LOG_LEVEL_ERROR, APP_LOG_LEVEL_ERROR, fmt, ## args)
+#define LOG_WARNING(fmt, args...) LOG_AT(LOG_LEVEL_WARNING, APP_LOG_LEVEL_WARNING, fmt, ## args)
+#define LOG_INFO(fmt, args...) LOG_AT(LOG_LEVEL_INFO, APP_LOG_LEVEL_INFO, fmt, ## args)
+#define LOG_DEBUG(fmt, args...) LOG_AT(LOG_LEVEL_DEBUG, APP_LOG_LEVEL_DEBUG, fmt, ## args)
+
+#if LOG_TRACE_ENTRIES > 0
+
+// Keeps the format and up to two int arguments, formatting happens at flush
+void log_trace(const char* fmt, int first, int second);
+void flush_traces();
+
+#define LOG_TRACE_ARGS(fmt, first, second, ...) log_trace(fmt, (int)(first), (int)(second))
+#define LOG_TRACE(args...) \
+    do { if(LOG_MODULE_LEVEL >= LOG_LEVEL_TRACE) LOG_TRACE_ARGS(args, 0, 0); } while(0)
+#define LOG_FLUSH_TRACES() flush_traces()
+
+#else
+
+#define LOG_TRACE(args...)
+#define LOG_FLUSH_TRACES()
+
+#endif
\ No newline at end of file
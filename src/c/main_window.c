@@ -5,6 +5,9 @@
 #include "main_window_logic.h"
 #include "icons.h"
 #include "persistance.h"
+#include "profiler.h"
+#include "heap_tracker.h"
+#include "layout.h"
 
 static Window *main_window;
 
@@ -12,39 +15,78 @@ static StatusBarLayer* status_bar;
 
 static Layer* main_layer;
 
+static Layer* circle_layer;
+
+static TextLayer* phase_text_layer;
+
 static ActionBarLayer* action_bar;
 
+static bool m_start_on_load = false;
+
 static void main_window_click_config_provider(void* context)
 {
     window_single_click_subscribe(BUTTON_ID_UP, toggle_exercise);
     window_single_click_subscribe(BUTTON_ID_SELECT, toggle_running);
     window_single_click_subscribe(BUTTON_ID_DOWN, goto_config_window);
+    PROFILE_SUBSCRIBE_OVERLAY_TOGGLE(BUTTON_ID_UP);
 }
 
 static void setup_main_window_action_bar_layer(Layer *window_layer, GRect bounds)
 {
-    action_bar = action_bar_layer_create();
+    action_bar = TRACK_CREATE(HeapTagLayers, action_bar_layer_create());
     action_bar_layer_set_background_color(action_bar, get_foreground_color());
     action_bar_layer_add_to_window(action_bar, main_window);
     action_bar_layer_set_click_config_provider(action_bar, main_window_click_config_provider);
-
-    action_bar_layer_set_icon_animated(action_bar, BUTTON_ID_UP, get_swap_icon(), true);
-    action_bar_layer_set_icon_animated(action_bar, BUTTON_ID_SELECT, get_play_icon(), true);
-    action_bar_layer_set_icon_animated(action_bar, BUTTON_ID_DOWN, get_config_icon(), true);
 }
 
 
+static GRect get_unobstructed_window_bounds()
+{
+    Layer* window_layer = window_get_root_layer(main_window);
+#if PBL_API_EXISTS(layer_get_unobstructed_bounds)
+    return layer_get_unobstructed_bounds(window_layer);
+#else
+    return layer_get_bounds(window_layer);
+#endif
+}
+
 static void setup_main_layer(Layer *window_layer, GRect bounds)
 {
-    main_layer = layer_create(GRect(bounds.origin.x, STATUS_BAR_LAYER_HEIGHT, bounds.size.w - ACTION_BAR_WIDTH, bounds.size.h - STATUS_BAR_LAYER_HEIGHT));
+    update_layout(get_unobstructed_window_bounds());
+    const Layout* layout = get_layout();
+
+    main_layer = TRACK_CREATE(HeapTagLayers, layer_create(layout->main_frame));
     layer_set_update_proc(main_layer, update_main_layer);
     layer_add_child(window_layer, main_layer);
 
+    circle_layer = TRACK_CREATE(HeapTagLayers, layer_create(layout->circle_frame));
+    layer_set_update_proc(circle_layer, update_circle_layer);
+    layer_add_child(main_layer, circle_layer);
+
+    phase_text_layer = TRACK_CREATE(HeapTagLayers, text_layer_create(layout->text_frame));
+    layer_add_child(main_layer, text_layer_get_layer(phase_text_layer));
+
+    PROFILE_SETUP_OVERLAY(main_layer, GRect(0, 0, layout->main_frame.size.w, 16));
+}
+
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+static void handle_unobstructed_area_changed(void* context)
+{
+    if(!update_layout(get_unobstructed_window_bounds()))
+    {
+        return;
+    }
+    const Layout* layout = get_layout();
+    layer_set_frame(main_layer, layout->main_frame);
+    layer_set_frame(circle_layer, layout->circle_frame);
+    layer_set_frame(text_layer_get_layer(phase_text_layer), layout->text_frame);
+    handle_layout_changed();
 }
+#endif
 
 static void setup_status_bar(Layer *window_layer, GRect bounds)
 {
-    status_bar = status_bar_layer_create();
+    status_bar = TRACK_CREATE(HeapTagLayers, status_bar_layer_create());
 
     status_bar_layer_set_colors(status_bar, get_background_color(), get_foreground_color());
     status_bar_layer_set_separator_mode(status_bar, StatusBarLayerSeparatorModeDotted);
@@ -54,7 +96,7 @@ static void setup_status_bar(Layer *window_layer, GRect bounds)
 
 static void load_main_window(Window *window)
 {
-    window_set_background_color(window, get_background_color());
+    window_set_background_color(window, GColorClear);
     Layer *window_layer = window_get_root_layer(window);
     GRect bounds = layer_get_bounds(window_layer);
 
@@ -64,13 +106,22 @@ static void load_main_window(Window *window)
 
     setup_layers(
         main_layer,
+        circle_layer,
+        phase_text_layer,
         action_bar,
         status_bar,
         main_window);
 
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+    // Only the final area matters, the layout is not animated with the peek
+    unobstructed_area_service_subscribe((UnobstructedAreaHandlers) {
+        .did_change = handle_unobstructed_area_changed
+    }, NULL);
+#endif
+
     reset_breathing();
 
-    if(use_auto_start())
+    if(!resume_handed_off_session() && (m_start_on_load || use_auto_start()))
     {
         start_breathing();
     }
@@ -78,26 +129,56 @@ static void load_main_window(Window *window)
 
 static void unload_main_window(Window *window)
 {
+    end_breathing();
+#if PBL_API_EXISTS(unobstructed_area_service_unsubscribe)
+    unobstructed_area_service_unsubscribe();
+#endif
     action_bar_layer_remove_from_window(action_bar);
-    action_bar_layer_destroy(action_bar);
-    status_bar_layer_destroy(status_bar);
-    layer_destroy(main_layer);
+    release_action_bar_icons();
+    TRACK_DESTROY(action_bar_layer_destroy, action_bar);
+    TRACK_DESTROY(status_bar_layer_destroy, status_bar);
+    PROFILE_TEAR_DOWN_OVERLAY();
+    TRACK_DESTROY(text_layer_destroy, phase_text_layer);
+    TRACK_DESTROY(layer_destroy, circle_layer);
+    TRACK_DESTROY(layer_destroy, main_layer);
 }
 
-void setup_main_window(GColor8 background_color, GColor8 foreground_color)
+static void create_main_window()
 {
-    main_window = window_create();
+    main_window = TRACK_CREATE(HeapTagWindows, window_create());
 
     window_set_window_handlers(main_window, (WindowHandlers) {
         .load = load_main_window,
         .unload = unload_main_window,
         .appear = update_main_window
     });
+}
 
+void setup_main_window(GColor8 background_color, GColor8 foreground_color)
+{
+    create_main_window();
     window_stack_push(main_window, true);
 }
 
+void setup_main_window_for_reminder()
+{
+    // Breathes right away and skips the push animation and the action bar
+    // icons, load_deferred_action_bar_icons adds them once the session runs
+    m_start_on_load = true;
+    defer_action_bar_icons();
+    create_main_window();
+    window_stack_push(main_window, false);
+}
+
+void refresh_main_window()
+{
+    if(main_window != NULL && window_stack_get_top_window() == main_window)
+    {
+        update_main_window(main_window);
+    }
+}
+
 void tear_down_main_window()
 {
-    window_destroy(main_window);
+    TRACK_DESTROY(window_destroy, main_window);
 }
\ No newline at end of file
@@ -3,4 +3,7 @@
 #include <pebble.h>
 
 void setup_main_window(GColor8 background_color, GColor8 foreground_color);
+void setup_main_window_for_reminder();
+// Applies changed settings when the main window is showing
+void refresh_main_window();
 void tear_down_main_window();
\ No newline at end of file
@@ -1,89 +1,88 @@
 #include "main_window_logic.h"
 
+#define LOG_MODULE_LEVEL LOG_LEVEL_MAIN_WINDOW
+#include "log.h"
+
 #include "config_menu_window.h"
 #include "persistance.h"
 #include "icons.h"
-
-#define FPS (20)
-#define MAX_BREATH_CIRCLE_RADIUS (50)
-#define MIN_BREATH_CIRCLE_RADIUS (10)
-
-static const uint16_t refresh_interval_ms = 1000 / FPS;
-static GPoint m_circle_center;
-static GRect m_circle_empty_rect;
-static GRect m_circle_full_rect;
-static GRect m_main_layer_text_area;
-static GFont m_text_font;
+#include "progress.h"
+#include "breath_renderer.h"
+#include "session_timeline.h"
+#include "exercise_program.h"
+#include "exercise_library.h"
+#include "custom_exercise.h"
+#include "session_history.h"
+#include "profiler.h"
+#include "backlight.h"
+#include "power_profile.h"
+#include "haptic_segments.h"
+#include "session_worker.h"
+#include "layout.h"
+
+static bool m_background_invalid = true;
 
 static const char* BREATH_IN_TEXT = "Breath In";
 static const char* BREATH_OUT_TEXT = "Breath Out";
+static const char* HOLD_EMPTY_BREATH_TEXT = "Hold Empty Breath";
+static const char* HOLD_FULL_BREATH_TEXT = "Hold Full Breath";
+static const char* HAPTIC_ONLY_TEXT = "Follow the vibrations";
 
-typedef enum {
-    OrificeNONE,
-    Mouth,
-    Nose,
-} Orifice;
-
-typedef enum {
-    ActionTypeNONE,
-    BreatheIn,
-    BreatheOut,
-    HoldFullBreath,
-    HoldEmptyBreath,
-} ActionType;
-
-typedef struct {
-    uint32_t original_ms;
-    uint32_t remaining_ms;
-    uint32_t animation_ms;
-    Orifice orifice;
-    ActionType type;
-} Action;
-
-typedef struct {
-  Action *array;
-  size_t used;
-  size_t size;
-} ActionArray;
-
-void initArray(ActionArray *a, size_t initialSize) {
-  a->array = malloc(initialSize * sizeof(Action));
-  a->used = 0;
-  a->size = initialSize;
-}
-
-void insertArray(ActionArray *a, Action element) {
-  // a->used is the number of used entries, because a->array[a->used++] updates a->used only *after* the array has been accessed.
-  // Therefore a->used can go up to a->size
-  if (a->used == a->size) {
-    a->size *= 2;
-    a->array = realloc(a->array, a->size * sizeof(Action));
-  }
-  a->array[a->used++] = element;
-}
-
-void freeArray(ActionArray *a) {
-  free(a->array);
-  a->array = NULL;
-  a->used = a->size = 0;
-}
+// Used when the exercise library resource can not be read
+static const Exercise FALLBACK_EXERCISE =
+{
+    .name = "Classic",
+    .program =
+    {
+        PROGRAM_PHASE(BreatheIn, Mouth, 4),
+        PROGRAM_PHASE(BreatheOut, Mouth, 4),
+        PROGRAM_PHASE(HoldEmptyBreath, Mouth, 4),
+        PROGRAM_PHASE(BreatheIn, Mouth, 4),
+        PROGRAM_PHASE(HoldFullBreath, Mouth, 4),
+        PROGRAM_END,
+    },
+};
 
 Window* m_main_window;
 ActionBarLayer* m_action_bar;
 StatusBarLayer* m_status_bar;
 
 Layer* m_main_layer;
-
-static ActionArray m_actions;
-static Action* m_current_action;
-uint16_t m_current_action_index;
+Layer* m_circle_layer;
+TextLayer* m_phase_text_layer;
+static const char* m_phase_text = NULL;
+
+static Exercise m_exercise;
+// The custom exercise is streamed from storage, m_exercise only has its name
+static bool m_custom_exercise = false;
+static ProgramCursor m_program;
+// Length of the loaded program, worked out once as it is loaded since a
+// custom one has to be read back from storage for it
+static uint32_t m_program_duration_ms;
+static Action m_action;
+static Action* m_current_action = NULL;
+static uint32_t m_current_action_start_ms;
+
+static bool m_session_started = false;
+static time_t m_session_start_time;
+// The exercise the session runs, the setting may move on before it is recorded
+static uint8_t m_session_exercise_index;
 
 static AppTimer* m_refresh_timer = NULL;
 
 static bool m_running;
+static bool m_haptic_only;
+
+// References held on the icons the action bar shows, indexed by button
+static GBitmap* m_action_bar_icons[NUM_BUTTONS];
+static bool m_action_bar_icons_deferred = false;
 
 static void stop_breathing();
 static void refresh_main_layer(void* data);
+static void schedule_main_layer_refresh();
+static void cancel_main_layer_refresh();
+static void update_phase_text();
+static void invalidate_main_layer();
 
 static const uint32_t const segments[] = { 50, 25, 50 };
 static const VibePattern m_vibration_pattern =
@@ -92,94 +91,242 @@ static const VibePattern m_vibration_pattern =
     .num_segments = ARRAY_LENGTH(segments),
 };
 
-static void debug_seed()
+// Haptic only sessions are guided by feel alone
+static const VibePattern HAPTIC_PATTERNS[] =
 {
-    initArray(&m_actions, 2);
-    Action in =
+    [BreatheIn] = VIBE_PATTERN(BREATHE_IN_SEGMENTS),
+    [BreatheOut] = VIBE_PATTERN(BREATHE_OUT_SEGMENTS),
+    [HoldFullBreath] = VIBE_PATTERN(HOLD_FULL_BREATH_SEGMENTS),
+    [HoldEmptyBreath] = VIBE_PATTERN(HOLD_EMPTY_BREATH_SEGMENTS),
+};
+static const VibePattern SESSION_END_PATTERN = VIBE_PATTERN(SESSION_END_SEGMENTS);
+
+static void vibrate_action_start(const Action* action)
+{
+    if(!m_haptic_only)
     {
-        .type = BreatheIn,
-        .orifice = Mouth,
-        .original_ms = 4000,
-        .remaining_ms = 4000,
-        .animation_ms = 0,
-    };
-    Action out =
+        vibes_enqueue_custom_pattern(m_vibration_pattern);
+    } else if(action->type < ARRAY_LENGTH(HAPTIC_PATTERNS) && HAPTIC_PATTERNS[action->type].durations != NULL)
     {
-        .type = BreatheOut,
-        .orifice = Mouth,
-        .original_ms = 4000,
-        .remaining_ms = 4000,
-        .animation_ms = 0,
-    };
-    Action hold_empty =
+        vibes_enqueue_custom_pattern(HAPTIC_PATTERNS[action->type]);
+    }
+}
+
+static uint32_t get_current_action_elapsed_ms()
+{
+    uint32_t elapsed_ms = get_timeline_elapsed_ms();
+    return elapsed_ms > m_current_action_start_ms ? elapsed_ms - m_current_action_start_ms : 0;
+}
+
+static void start_exercise_program(ProgramCursor* cursor, uint8_t quad_time)
+{
+    if(m_custom_exercise)
     {
-        .type = HoldEmptyBreath,
-        .orifice = Mouth,
-        .original_ms = 4000,
-        .remaining_ms = 4000,
-        .animation_ms = 0,
-    };
-    Action hold_full =
+        start_custom_program(cursor, quad_time);
+    } else {
+        start_program(cursor, m_exercise.program, quad_time);
+    }
+}
+
+static void record_session(bool aborted)
+{
+    if(!m_session_started)
     {
-        .type = HoldFullBreath,
-        .orifice = Mouth,
-        .original_ms = 4000,
-        .remaining_ms = 4000,
-        .animation_ms = 0,
+        return;
+    }
+    m_session_started = false;
+    PROFILE_END_SESSION();
+    LOG_INFO("Backlight was on for %d s", (int)(get_backlight_lit_ms() / 1000));
+
+    SessionRecord record =
+    {
+        .start_time = (uint32_t)m_session_start_time,
+        .planned_s = m_program_duration_ms / 1000,
+        .actual_s = get_timeline_elapsed_ms() / 1000,
+        .exercise_index = m_session_exercise_index,
+        .flags = aborted ? SESSION_ABORTED : 0,
     };
+    append_session_record(&record);
+}
 
-    insertArray(&m_actions, in);
-    insertArray(&m_actions, out);
-    insertArray(&m_actions, hold_empty);
-    insertArray(&m_actions, in);
-    insertArray(&m_actions, hold_full);
+static void finish_session()
+{
+    stop_breathing();
+    record_session(false);
+    if(use_auto_kill())
+    {
+        exit_reason_set(APP_EXIT_ACTION_PERFORMED_SUCCESSFULLY);
+        window_stack_remove(m_main_window, true);
+    } else {
+        reset_breathing();
+    }
 }
 
-static void on_sec_tick(struct tm *tick_time, TimeUnits units_changed)
+// Moves to whichever action the timeline is in, returns false if the session
+// is over. Without notify it catches up silently, like when a session is
+// taken back from the worker which already gave the cues.
+static bool advance_actions(bool notify)
 {
-    m_current_action->remaining_ms -= 1000;
-    m_current_action->animation_ms = m_current_action->original_ms - m_current_action->remaining_ms;
-    if(m_current_action->remaining_ms <= 0)
+    uint32_t elapsed_ms = get_timeline_elapsed_ms();
+    bool action_changed = false;
+    while(elapsed_ms >= m_current_action_start_ms + m_current_action->duration_ms)
     {
-        vibes_enqueue_custom_pattern(m_vibration_pattern);
-        m_current_action_index++;
-        if(m_current_action_index < m_actions.used)
+        m_current_action_start_ms += m_current_action->duration_ms;
+        if(!next_program_action(&m_program, m_current_action))
         {
-            m_current_action = &m_actions.array[m_current_action_index];
-        } else {
-            stop_breathing();
-            if(use_auto_kill())
+            if(notify)
             {
-                exit_reason_set(APP_EXIT_ACTION_PERFORMED_SUCCESSFULLY);
-                window_stack_remove(m_main_window, true);
-            } else {
-                reset_breathing();
+                vibes_enqueue_custom_pattern(m_haptic_only ? SESSION_END_PATTERN : m_vibration_pattern);
             }
+            return false;
         }
+        action_changed = true;
     }
+    if(action_changed && notify)
+    {
+        LOG_FLUSH_TRACES();
+        vibrate_action_start(m_current_action);
+        update_backlight(m_current_action);
+        update_phase_text();
+    }
+    return true;
+}
+
+static void set_action_bar_icon(ButtonId button_id, GBitmap* icon)
+{
+    GBitmap* previous_icon = m_action_bar_icons[button_id];
+    if(icon != previous_icon)
+    {
+        action_bar_layer_set_icon_animated(m_action_bar, button_id, icon, true);
+        m_action_bar_icons[button_id] = icon;
+    }
+    release_icon(previous_icon);
 }
 
 static void update_action_bar_icons()
 {
+    if(m_action_bar_icons_deferred)
+    {
+        return;
+    }
+
     GBitmap* middle_icon = m_running ? get_pause_icon() : get_play_icon();
 
-    action_bar_layer_set_icon_animated(m_action_bar, BUTTON_ID_UP, get_swap_icon(), true);
-    action_bar_layer_set_icon_animated(m_action_bar, BUTTON_ID_SELECT, middle_icon, true);
-    action_bar_layer_set_icon_animated(m_action_bar, BUTTON_ID_DOWN, get_config_icon(), true);
+    set_action_bar_icon(BUTTON_ID_UP, get_swap_icon());
+    set_action_bar_icon(BUTTON_ID_SELECT, middle_icon);
+    set_action_bar_icon(BUTTON_ID_DOWN, get_config_icon());
+}
+
+void defer_action_bar_icons()
+{
+    m_action_bar_icons_deferred = true;
+}
+
+void load_deferred_action_bar_icons()
+{
+    m_action_bar_icons_deferred = false;
+    update_action_bar_icons();
+}
+
+void release_action_bar_icons()
+{
+    for(uint8_t i = 0; i < NUM_BUTTONS; i++)
+    {
+        release_icon(m_action_bar_icons[i]);
+        m_action_bar_icons[i] = NULL;
+    }
+}
+
+static const char* get_phase_text()
+{
+    if(m_current_action == NULL)
+    {
+        return NULL;
+    }
+    if(!m_running && get_timeline_elapsed_ms() == 0)
+    {
+        return m_exercise.name;
+    }
+    if(m_running && m_haptic_only)
+    {
+        return HAPTIC_ONLY_TEXT;
+    }
+    switch (m_current_action->type)
+    {
+        case BreatheIn:
+            return m_running ? BREATH_IN_TEXT : NULL;
+        case BreatheOut:
+            return m_running ? BREATH_OUT_TEXT : NULL;
+        case HoldEmptyBreath:
+            return HOLD_EMPTY_BREATH_TEXT;
+        case HoldFullBreath:
+            return HOLD_FULL_BREATH_TEXT;
+        default:
+            return NULL;
+    }
+}
+
+static void update_phase_text()
+{
+    const char* text = get_phase_text();
+    if(text != m_phase_text)
+    {
+        m_phase_text = text;
+        // Setting the text is what marks the label layer dirty, so it is
+        // only touched when the phase or running state actually changes
+        text_layer_set_text(m_phase_text_layer, text != NULL ? text : "");
+    }
+}
+
+static uint32_t get_action_steps(Action* action)
+{
+    const PowerProfileSettings* profile = get_power_profile_settings();
+    switch (action->type)
+    {
+        case BreatheIn:
+        case BreatheOut:
+            return profile->radius_steps > 0 ? profile->radius_steps : get_layout()->max_radius - get_layout()->min_radius;
+        case HoldEmptyBreath:
+            return profile->animate_holds ? get_arc_length(get_layout()->min_radius) : 0;
+        case HoldFullBreath:
+            return profile->animate_holds ? get_arc_length(get_layout()->max_radius) : 0;
+        default:
+            return 0;
+    }
 }
 
 static void schedule_main_layer_refresh()
 {
+    // Sleep until the circle has moved at least one step, capped by the
+    // power profile, and after the final frame of an action sleep until
+    // the next one starts
+    uint32_t elapsed_ms = get_current_action_elapsed_ms();
+    uint32_t remaining_ms = elapsed_ms < m_current_action->duration_ms ? m_current_action->duration_ms - elapsed_ms : 0;
+    uint32_t delay_ms = get_ms_until_next_step(
+        elapsed_ms,
+        m_current_action->duration_ms,
+        get_action_steps(m_current_action));
+    uint16_t refresh_interval_ms = get_power_profile_settings()->refresh_interval_ms;
+    if(delay_ms < refresh_interval_ms)
+    {
+        delay_ms = refresh_interval_ms;
+    }
+    if(delay_ms > remaining_ms || m_haptic_only)
+    {
+        // Haptic only sessions draw nothing, they only wake at phase boundaries
+        delay_ms = remaining_ms;
+    }
+
     bool rescheduled = false;
     if(m_refresh_timer != NULL)
     {
-        rescheduled = app_timer_reschedule(m_refresh_timer, refresh_interval_ms);
+        rescheduled = app_timer_reschedule(m_refresh_timer, delay_ms);
     }
     if(!rescheduled)
     {
-        m_refresh_timer = app_timer_register(refresh_interval_ms, refresh_main_layer, NULL);
+        m_refresh_timer = app_timer_register(delay_ms, refresh_main_layer, NULL);
     }
-
+    PROFILE_FRAME_SCHEDULED(delay_ms);
 }
 
 static void cancel_main_layer_refresh()
@@ -194,27 +341,68 @@ static void cancel_main_layer_refresh()
 static void refresh_main_layer(void* data)
 {
     m_refresh_timer = NULL;
-    layer_mark_dirty(m_main_layer);
+    PROFILE_FRAME_TIMER_FIRED();
+    if(!advance_actions(true))
+    {
+        finish_session();
+        return;
+    }
+    if(!m_haptic_only)
+    {
+        layer_mark_dirty(m_circle_layer);
+    }
     schedule_main_layer_refresh();
 }
 
+static void handle_power_profile_changed(PowerProfile profile)
+{
+    // The next frame is drawn from scratch with the new profile's steps
+    invalidate_breath_renderer();
+    if(!m_haptic_only)
+    {
+        layer_mark_dirty(m_circle_layer);
+    }
+    schedule_main_layer_refresh();
+}
 
 void start_breathing()
 {
+    if(m_current_action == NULL || m_running)
+    {
+        return;
+    }
+    if(!m_session_started)
+    {
+        m_session_started = true;
+        m_session_start_time = time(NULL);
+        m_session_exercise_index = get_exercise_index();
+        reset_backlight_lit_time();
+        PROFILE_BEGIN_SESSION();
+    }
     m_running = true;
-    tick_timer_service_subscribe(SECOND_UNIT, on_sec_tick);
+    m_haptic_only = use_haptic_only();
+    start_power_profile(handle_power_profile_changed);
+    resume_timeline();
     update_action_bar_icons();
-    light_enable(true);
+    update_phase_text();
+    if(m_haptic_only)
+    {
+        vibrate_action_start(m_current_action);
+    }
+    start_backlight(m_haptic_only ? BacklightOff : get_backlight_mode(), m_current_action);
     schedule_main_layer_refresh();
 }
 
 static void stop_breathing()
 {
     m_running = false;
-    tick_timer_service_unsubscribe();
+    pause_timeline();
     update_action_bar_icons();
-    light_enable(false);
+    update_phase_text();
+    stop_backlight();
+    stop_power_profile();
     cancel_main_layer_refresh();
+    LOG_FLUSH_TRACES();
 }
 
 
@@ -229,38 +417,177 @@ void toggle_running(ClickRecognizerRef recognizer, void* context)
     m_running ? stop_breathing() : start_breathing();
 }
 
+// The custom exercise comes after the library ones once there is one
+static uint8_t get_next_exercise_index(uint8_t index)
+{
+    if(index != CUSTOM_EXERCISE_INDEX && index + 1 < get_exercise_count())
+    {
+        return index + 1;
+    }
+    return index != CUSTOM_EXERCISE_INDEX && has_custom_exercise() ? CUSTOM_EXERCISE_INDEX : 0;
+}
+
 void toggle_exercise(ClickRecognizerRef recognizer, void* context)
 {
-    // TODO: Add more exercises
+    set_exercise_index(get_next_exercise_index(get_exercise_index()));
     reset_breathing();
 }
 
+static bool load_custom_exercise()
+{
+    CustomExerciseHeader header;
+    if(!read_custom_exercise_header(&header) || !header.complete)
+    {
+        return false;
+    }
+    memset(&m_exercise, 0, sizeof(Exercise));
+    copy_custom_exercise_name(m_exercise.name, sizeof(m_exercise.name), header.name, sizeof(header.name));
+    m_exercise.program[0] = (ProgramInstruction)PROGRAM_END;
+    return true;
+}
+
+static void load_exercise_or_fallback(uint8_t index)
+{
+    m_custom_exercise = index == CUSTOM_EXERCISE_INDEX && load_custom_exercise();
+    if(!m_custom_exercise && !load_exercise(index, &m_exercise))
+    {
+        m_exercise = FALLBACK_EXERCISE;
+    }
+}
+
 void reset_breathing()
 {
-    debug_seed();
-    m_current_action_index = 0;
-    m_current_action = &m_actions.array[m_current_action_index];
+    record_session(true);
+    load_exercise_or_fallback(get_exercise_index());
+    start_exercise_program(&m_program, get_current_quad_time());
+    m_program_duration_ms = get_program_duration_ms(&m_program);
+    m_current_action = next_program_action(&m_program, &m_action) ? &m_action : NULL;
+    m_current_action_start_ms = 0;
+    reset_timeline();
+    stop_breathing();
+    m_phase_text = NULL;
+    update_phase_text();
+    invalidate_main_layer();
+}
+
+static void hand_off_running_session()
+{
+    SessionHandoff handoff =
+    {
+        .version = SESSION_HANDOFF_VERSION,
+        .state = HandoffRunning,
+        .quad_time = m_program.quad_time,
+        .exercise_index = m_session_exercise_index,
+        .session_start_time = (uint32_t)m_session_start_time,
+        .elapsed_ms = get_timeline_elapsed_ms(),
+        .wall_ms = get_now_ms(),
+    };
+    // The worker streams the custom exercise from storage itself
+    memcpy(handoff.program, m_exercise.program, sizeof(handoff.program));
+    hand_off_session(&handoff);
+    // The worker owns the session now, it is recorded once it is taken back
+    m_session_started = false;
+}
+
+void end_breathing()
+{
+    if(m_running)
+    {
+        hand_off_running_session();
+    }
     stop_breathing();
+    record_session(true);
+}
+
+static void resume_session(const SessionHandoff* handoff)
+{
+    record_session(true);
+    load_exercise_or_fallback(handoff->exercise_index);
+    memcpy(m_exercise.program, handoff->program, sizeof(m_exercise.program));
+    start_exercise_program(&m_program, handoff->quad_time);
+    m_program_duration_ms = get_program_duration_ms(&m_program);
+    m_current_action = next_program_action(&m_program, &m_action) ? &m_action : NULL;
+    m_current_action_start_ms = 0;
+    if(m_current_action == NULL)
+    {
+        return;
+    }
+    set_timeline_elapsed_ms(get_handoff_elapsed_ms(handoff, get_now_ms()));
+    m_session_started = true;
+    m_session_start_time = handoff->session_start_time;
+    m_session_exercise_index = handoff->exercise_index;
+
+    if(handoff->state == HandoffFinished || !advance_actions(false))
+    {
+        // It ended while the app was closed
+        record_session(false);
+        reset_breathing();
+        return;
+    }
+    m_phase_text = NULL;
+    invalidate_main_layer();
+    start_breathing();
+}
+
+bool resume_handed_off_session()
+{
+    return take_back_session(resume_session);
+}
+
+void reload_custom_exercise()
+{
+    invalidate_custom_program();
+    if(get_exercise_index() == CUSTOM_EXERCISE_INDEX)
+    {
+        // Also stops a session of the exercise that was replaced
+        reset_breathing();
+    }
+}
+
+static void invalidate_main_layer()
+{
+    m_background_invalid = true;
+    invalidate_breath_renderer();
     layer_mark_dirty(m_main_layer);
 }
 
+static void setup_renderer_for_layout()
+{
+    const Layout* layout = get_layout();
+    setup_breath_renderer(
+        GPoint(layout->max_radius, layout->max_radius),
+        GPoint(
+            layout->main_frame.origin.x + layout->circle_frame.origin.x,
+            layout->main_frame.origin.y + layout->circle_frame.origin.y));
+}
+
+void handle_layout_changed()
+{
+    setup_renderer_for_layout();
+    invalidate_main_layer();
+    if(m_running)
+    {
+        schedule_main_layer_refresh();
+    }
+}
+
 void setup_layers(
     Layer* main_layer,
+    Layer* circle_layer,
+    TextLayer* phase_text_layer,
     ActionBarLayer* action_bar,
     StatusBarLayer* status_bar,
     Window* main_window)
 {
     m_main_layer = main_layer;
+    m_circle_layer = circle_layer;
+    m_phase_text_layer = phase_text_layer;
+    m_phase_text = NULL;
 
-    GRect bounds = layer_get_bounds(main_layer);
-    m_circle_center = GPoint((bounds.origin.x + bounds.size.w)/2 - 2, (bounds.origin.y + bounds.size.h)/2 - 10);
-    m_main_layer_text_area = GRect(bounds.origin.x, bounds.size.h - bounds.origin.y - 20 - 8, bounds.size.w, 20);
-    m_text_font = fonts_get_system_font(FONT_KEY_GOTHIC_18);
+    setup_renderer_for_layout();
 
-    m_circle_empty_rect = GRect(m_circle_center.x - MIN_BREATH_CIRCLE_RADIUS, m_circle_center.y - MIN_BREATH_CIRCLE_RADIUS, MIN_BREATH_CIRCLE_RADIUS * 2, MIN_BREATH_CIRCLE_RADIUS * 2);
-    m_circle_full_rect = GRect(m_circle_center.x - MAX_BREATH_CIRCLE_RADIUS, m_circle_center.y - MAX_BREATH_CIRCLE_RADIUS, MAX_BREATH_CIRCLE_RADIUS * 2, MAX_BREATH_CIRCLE_RADIUS * 2);
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "empty: x:%d y:%d, w:%d, h:%d", m_circle_empty_rect.origin.x, m_circle_empty_rect.origin.y, m_circle_empty_rect.size.w, m_circle_empty_rect.size.h);
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "full: x:%d y:%d, w:%d, h:%d", m_circle_full_rect.origin.x, m_circle_full_rect.origin.y, m_circle_full_rect.size.w, m_circle_full_rect.size.h);
+    text_layer_set_font(phase_text_layer, fonts_get_system_font(get_layout_spec()->text_font_key));
+    text_layer_set_text_alignment(phase_text_layer, GTextAlignmentCenter);
 
     m_action_bar = action_bar;
     m_status_bar = status_bar;
@@ -269,68 +596,78 @@ void setup_layers(
 
 void update_main_window(Window *window)
 {
-    window_set_background_color(window, get_background_color());
+    // The circle layer repaints only what changed, so the window must not
+    // clear the frame buffer before every render
+    window_set_background_color(window, GColorClear);
     status_bar_layer_set_colors(m_status_bar, get_background_color(), get_foreground_color());
     action_bar_layer_set_background_color(m_action_bar, get_foreground_color());
+    text_layer_set_background_color(m_phase_text_layer, get_background_color());
+    text_layer_set_text_color(m_phase_text_layer, get_foreground_color());
 
+    invalidate_icons();
     update_action_bar_icons();
 
-    layer_mark_dirty(m_main_layer);
+    invalidate_main_layer();
 }
 
 void update_main_layer(struct Layer *layer, GContext *ctx)
+{
+    if(m_background_invalid)
+    {
+        graphics_context_set_fill_color(ctx, get_background_color());
+        graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
+        m_background_invalid = false;
+    }
+}
+
+void update_circle_layer(struct Layer *layer, GContext *ctx)
 {
     if(m_current_action != NULL)
     {
-        float progress_procentage = 1 - (float)(m_current_action->original_ms - m_current_action->animation_ms) / ((float)m_current_action->original_ms);
-        graphics_context_set_fill_color(ctx, get_foreground_color());
-        graphics_context_set_text_color(ctx, get_foreground_color());
-        if(m_running)
+        PROFILE_BEGIN_RENDER();
+        const PowerProfileSettings* profile = get_power_profile_settings();
+        uint32_t progress = get_progress(get_current_action_elapsed_ms(), m_current_action->duration_ms);
+        if(!profile->animate_holds && (m_current_action->type == HoldEmptyBreath || m_current_action->type == HoldFullBreath))
+        {
+            // The hold is shown as a still full disc
+            progress = 0;
+        } else
         {
-            m_current_action->animation_ms += refresh_interval_ms;
+            progress = quantize_progress(progress, profile->radius_steps);
         }
         switch (m_current_action->type)
         {
             case BreatheIn:
             {
-                uint8_t radius = ((MAX_BREATH_CIRCLE_RADIUS - MIN_BREATH_CIRCLE_RADIUS) * progress_procentage) + MIN_BREATH_CIRCLE_RADIUS;
-                APP_LOG(APP_LOG_LEVEL_DEBUG, "radius: %d, progress_procentage: %d", radius, (int)(progress_procentage * 100));
-                graphics_fill_circle(ctx, m_circle_center, radius);
-                if(m_running)
-                {
-                    graphics_draw_text(ctx, BREATH_IN_TEXT, m_text_font, m_main_layer_text_area, GTextOverflowModeFill, GTextAlignmentCenter, NULL);
-                }
+                uint16_t radius = interpolate_radius(get_layout()->min_radius, get_layout()->max_radius, progress);
+                LOG_TRACE("radius: %d, progress_procentage: %d", radius, progress_to_percent(progress));
+                render_breath_circle(layer, ctx, radius);
                 break;
             }
             case BreatheOut:
             {
-                uint8_t radius = ((MAX_BREATH_CIRCLE_RADIUS - MIN_BREATH_CIRCLE_RADIUS) * (1 - progress_procentage)) + MIN_BREATH_CIRCLE_RADIUS;
-                APP_LOG(APP_LOG_LEVEL_DEBUG, "radius: %d, progress_procentage: %d", radius, (int)(progress_procentage * 100));
-                graphics_fill_circle(ctx, m_circle_center, radius);
-                if(m_running)
-                {
-                    graphics_draw_text(ctx, BREATH_OUT_TEXT, m_text_font, m_main_layer_text_area, GTextOverflowModeFill, GTextAlignmentCenter, NULL);
-                }
+                uint16_t radius = interpolate_radius(get_layout()->max_radius, get_layout()->min_radius, progress);
+                LOG_TRACE("radius: %d, progress_procentage: %d", radius, progress_to_percent(progress));
+                render_breath_circle(layer, ctx, radius);
                 break;
             }
             case HoldEmptyBreath:
             {
-                int32_t start_angle = progress_procentage * 360;
-                APP_LOG(APP_LOG_LEVEL_DEBUG, "start_angle: %d", (int)start_angle);
-                graphics_fill_radial(ctx, m_circle_empty_rect, GOvalScaleModeFillCircle, MIN_BREATH_CIRCLE_RADIUS, DEG_TO_TRIGANGLE(start_angle), DEG_TO_TRIGANGLE(360));
-                graphics_draw_text(ctx, "Hold Empty Breath", m_text_font, m_main_layer_text_area, GTextOverflowModeFill, GTextAlignmentCenter, NULL);
+                int32_t start_angle = progress_to_trigangle(progress);
+                LOG_TRACE("start_angle: %d", TRIGANGLE_TO_DEG(start_angle));
+                render_hold_arc(layer, ctx, get_layout()->min_radius, start_angle);
                 break;
             }
             case HoldFullBreath:
             {
-                int32_t start_angle = progress_procentage * 360;
-                APP_LOG(APP_LOG_LEVEL_DEBUG, "start_angle: %d", (int)start_angle);
-                graphics_fill_radial(ctx, m_circle_full_rect, GOvalScaleModeFillCircle, MAX_BREATH_CIRCLE_RADIUS, DEG_TO_TRIGANGLE(start_angle), DEG_TO_TRIGANGLE(360));
-                graphics_draw_text(ctx, "Hold Full Breath", m_text_font, m_main_layer_text_area, GTextOverflowModeFill, GTextAlignmentCenter, NULL);
+                int32_t start_angle = progress_to_trigangle(progress);
+                LOG_TRACE("start_angle: %d", TRIGANGLE_TO_DEG(start_angle));
+                render_hold_arc(layer, ctx, get_layout()->max_radius, start_angle);
                 break;
             }
             default:
                 break;
         }
+        PROFILE_END_RENDER();
     }
 }
\ No newline at end of file
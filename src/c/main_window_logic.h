@@ -7,11 +7,22 @@ void toggle_running(ClickRecognizerRef recognizer, void* context);
 void toggle_exercise(ClickRecognizerRef recognizer, void* context);
 void setup_layers(
     Layer* main_layer,
+    Layer* circle_layer,
+    TextLayer* phase_text_layer,
     ActionBarLayer* action_bar,
     StatusBarLayer* status_bar,
     Window* main_window);
 void update_main_window(Window *window);
+void handle_layout_changed();
 void start_breathing();
 void reset_breathing();
+void end_breathing();
+bool resume_handed_off_session();
+// Picks up an uploaded custom exercise
+void reload_custom_exercise();
+void defer_action_bar_icons();
+void load_deferred_action_bar_icons();
+void release_action_bar_icons();
 
-void update_main_layer(struct Layer *layer, GContext *ctx);
\ No newline at end of file
+void update_main_layer(struct Layer *layer, GContext *ctx);
+void update_circle_layer(struct Layer *layer, GContext *ctx);
\ No newline at end of file
@@ -4,12 +4,32 @@
 #include <stdbool.h>
 #include <gcolor_definitions.h>
 
-static const uint32_t DATA_KEY = 659154;
+#define LOG_MODULE_LEVEL LOG_LEVEL_PERSISTANCE
+#include "log.h"
+
+static const uint32_t LEGACY_DATA_KEY = 659154;
+static const uint32_t DATA_KEY = 659155;
+
+
+// Holds the flash blob of any version while it is migrated
+typedef union {
+    DataV1 v1;
+    PersistedData packed;
+} StoredData;
+
+typedef void (*Migration)(StoredData* stored);
 
 static Data m_data;
 static bool m_data_loaded = false;
+static bool m_data_dirty = false;
+static bool m_legacy_data_present = false;
+
+static void mark_data_dirty()
+{
+    m_data_dirty = true;
+}
 
-static void seed_version_1_data(Data* data)
+static void seed_version_1_data(DataV1* data)
 {
     data->background_color = GColorBlack;
     data->foreground_color = GColorWhite;
@@ -20,52 +40,154 @@ static void seed_version_1_data(Data* data)
     data->auto_kill = false;
 }
 
-static void seed_data()
+static void migrate_v0_to_v1(StoredData* stored)
+{
+    // Version 0 never held user values
+    seed_version_1_data(&stored->v1);
+    stored->v1.data_version = 1;
+}
+
+static void migrate_v1_to_v2(StoredData* stored)
+{
+    DataV1 v1 = stored->v1;
+    memset(&stored->packed, 0, sizeof(PersistedData));
+    stored->packed.data_version = 2;
+    stored->packed.dark_theme = gcolor_equal(v1.background_color, GColorBlack);
+    stored->packed.short_quad_time = v1.short_quad_time;
+    stored->packed.long_quad_time = v1.long_quad_time;
+    stored->packed.current_is_long = v1.current_is_long;
+    stored->packed.auto_start = v1.auto_start;
+    stored->packed.auto_kill = v1.auto_kill;
+    stored->packed.exercise_index = 0;
+}
+
+static void migrate_v2_to_v3(StoredData* stored)
+{
+    stored->packed.data_version = 3;
+    stored->packed.haptic_only = false;
+}
+
+static void migrate_v3_to_v4(StoredData* stored)
+{
+    // Keeps the light on for the whole session like before
+    stored->packed.data_version = 4;
+    stored->packed.backlight_mode = BacklightAlwaysOn;
+}
+
+static void migrate_v4_to_v5(StoredData* stored)
 {
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "Seeding data");
-    seed_version_1_data(&m_data);
+    stored->packed.data_version = 5;
+    stored->packed.reduced_battery_threshold = 30 / BATTERY_THRESHOLD_STEP;
+    stored->packed.minimal_battery_threshold = 10 / BATTERY_THRESHOLD_STEP;
+}
 
-    m_data.data_version = CURRENT_DATA_VERSION;
-    save_data();
+static void migrate_v5_to_v6(StoredData* stored)
+{
+    stored->packed.data_version = 6;
+    stored->packed.reminder = 0;
 }
 
-static bool data_version_is_current(Data* data)
+// MIGRATIONS[n] takes a version n blob to version n + 1
+static const Migration MIGRATIONS[CURRENT_DATA_VERSION] =
+{
+    migrate_v0_to_v1,
+    migrate_v1_to_v2,
+    migrate_v2_to_v3,
+    migrate_v3_to_v4,
+    migrate_v4_to_v5,
+    migrate_v5_to_v6,
+};
+
+static void unpack_data(const PersistedData* packed, Data* data)
 {
-    bool is_current = true;
-    if(data->data_version < CURRENT_DATA_VERSION)
+    data->background_color = packed->dark_theme ? GColorBlack : GColorWhite;
+    data->foreground_color = packed->dark_theme ? GColorWhite : GColorBlack;
+    data->short_quad_time = packed->short_quad_time;
+    data->long_quad_time = packed->long_quad_time;
+    data->current_is_long = packed->current_is_long;
+    data->auto_start = packed->auto_start;
+    data->auto_kill = packed->auto_kill;
+    data->exercise_index = packed->exercise_index;
+    data->haptic_only = packed->haptic_only;
+    data->backlight_mode = packed->backlight_mode;
+    data->reduced_battery_threshold = packed->reduced_battery_threshold * BATTERY_THRESHOLD_STEP;
+    data->minimal_battery_threshold = packed->minimal_battery_threshold * BATTERY_THRESHOLD_STEP;
+    data->reminder_hour = packed->reminder > 0 ? packed->reminder - 1 : NO_REMINDER;
+}
+
+static void pack_data(const Data* data, PersistedData* packed)
+{
+    memset(packed, 0, sizeof(PersistedData));
+    packed->data_version = CURRENT_DATA_VERSION;
+    packed->dark_theme = gcolor_equal(data->background_color, GColorBlack);
+    packed->short_quad_time = data->short_quad_time;
+    packed->long_quad_time = data->long_quad_time;
+    packed->current_is_long = data->current_is_long;
+    packed->auto_start = data->auto_start;
+    packed->auto_kill = data->auto_kill;
+    packed->exercise_index = data->exercise_index;
+    packed->haptic_only = data->haptic_only;
+    packed->backlight_mode = data->backlight_mode;
+    packed->reduced_battery_threshold = data->reduced_battery_threshold / BATTERY_THRESHOLD_STEP;
+    packed->minimal_battery_threshold = data->minimal_battery_threshold / BATTERY_THRESHOLD_STEP;
+    packed->reminder = data->reminder_hour != NO_REMINDER ? data->reminder_hour + 1 : 0;
+}
+
+static void seed_data()
+{
+    LOG_DEBUG("Seeding data");
+    StoredData stored;
+    memset(&stored, 0, sizeof(StoredData));
+    for(uint8_t version = 0; version < CURRENT_DATA_VERSION; version++)
     {
-        APP_LOG(APP_LOG_LEVEL_DEBUG, "The data version:%d is lower than the current version:%d", data->data_version, CURRENT_DATA_VERSION);
-        is_current = false;
+        MIGRATIONS[version](&stored);
     }
-    return is_current;
+    unpack_data(&stored.packed, &m_data);
+    mark_data_dirty();
 }
 
-static void migrate_data(Data* data)
+static void migrate_data(StoredData* stored, uint8_t version)
 {
-    if(data->data_version < 1)
+    if(version > CURRENT_DATA_VERSION)
     {
-        APP_LOG(APP_LOG_LEVEL_DEBUG, "Migrating to data version 1");
-
-        seed_version_1_data(data);
-        data->data_version = 1;
+        LOG_WARNING("The data version:%d is newer than the current version:%d", version, CURRENT_DATA_VERSION);
+        return;
+    }
+    for(; version < CURRENT_DATA_VERSION; version++)
+    {
+        LOG_DEBUG("Migrating to data version %d", version + 1);
+        MIGRATIONS[version](stored);
+        mark_data_dirty();
     }
 }
 
-static Data* get_data()
+static void load_data()
 {
-    if(!has_any_data())
+    StoredData stored;
+    memset(&stored, 0, sizeof(StoredData));
+    if(persist_exists(DATA_KEY))
+    {
+        persist_read_data(DATA_KEY, &stored.packed, sizeof(PersistedData));
+        migrate_data(&stored, stored.packed.data_version);
+        unpack_data(&stored.packed, &m_data);
+    } else if(persist_exists(LEGACY_DATA_KEY))
+    {
+        m_legacy_data_present = true;
+        persist_read_data(LEGACY_DATA_KEY, &stored.v1, sizeof(DataV1));
+        migrate_data(&stored, stored.v1.data_version);
+        unpack_data(&stored.packed, &m_data);
+    } else
     {
         seed_data();
     }
+    m_data_loaded = true;
+}
+
+static Data* get_data()
+{
     if(!m_data_loaded)
     {
-        persist_read_data(DATA_KEY, &m_data, sizeof(Data));
-        m_data_loaded = true;
-        if(!data_version_is_current(&m_data))
-        {
-            migrate_data(&m_data);
-            save_data();
-        }
+        load_data();
     }
     return &m_data;
 }
@@ -90,29 +212,45 @@ void toggle_quad_time()
     Data* data = get_data();
     bool current = data->current_is_long;
     data->current_is_long = !current;
-    save_data();
+    mark_data_dirty();
 }
 
 void set_long_quad_time(uint8_t value)
 {
     get_data()->long_quad_time = value;
-    save_data();
+    mark_data_dirty();
 }
 
 void set_short_quad_time(uint8_t value)
 {
     get_data()->short_quad_time = value;
-    save_data();
+    mark_data_dirty();
 }
 
 bool has_any_data()
 {
-    return persist_exists(DATA_KEY);
+    return persist_exists(DATA_KEY) || persist_exists(LEGACY_DATA_KEY);
 }
 
 void save_data()
 {
-    persist_write_data(DATA_KEY, &m_data, sizeof(Data));
+    PersistedData packed;
+    pack_data(get_data(), &packed);
+    persist_write_data(DATA_KEY, &packed, sizeof(PersistedData));
+    if(m_legacy_data_present)
+    {
+        persist_delete(LEGACY_DATA_KEY);
+        m_legacy_data_present = false;
+    }
+    m_data_dirty = false;
+}
+
+void flush_data()
+{
+    if(m_data_dirty)
+    {
+        save_data();
+    }
 }
 
 GColor8 get_background_color()
@@ -132,15 +270,19 @@ bool is_dark_theme()
     return (background == black);
 }
 
-void toggle_theme()
+void set_dark_theme(bool dark)
 {
+    if(dark == is_dark_theme())
+    {
+        return;
+    }
     Data* data = get_data();
     GColor8 previous_background_color = data->background_color;
     GColor8 previous_foreground_color = data->foreground_color;
 
     data->background_color = previous_foreground_color;
     data->foreground_color = previous_background_color;
-    save_data();
+    mark_data_dirty();
 }
 
 bool use_auto_start()
@@ -148,11 +290,10 @@ bool use_auto_start()
     return get_data()->auto_start;
 }
 
-void toggle_auto_start()
+void set_auto_start(bool value)
 {
-    Data* data = get_data();
-    data->auto_start = !data->auto_start;
-    save_data();
+    get_data()->auto_start = value;
+    mark_data_dirty();
 }
 
 bool use_auto_kill()
@@ -160,11 +301,85 @@ bool use_auto_kill()
     return get_data()->auto_kill;
 }
 
-void toggle_auto_kill()
+void set_auto_kill(bool value)
+{
+    get_data()->auto_kill = value;
+    mark_data_dirty();
+}
+
+bool use_haptic_only()
+{
+    return get_data()->haptic_only;
+}
+
+void set_haptic_only(bool value)
+{
+    get_data()->haptic_only = value;
+    mark_data_dirty();
+}
+
+BacklightMode get_backlight_mode()
+{
+    return get_data()->backlight_mode;
+}
+
+void set_backlight_mode(BacklightMode mode)
+{
+    get_data()->backlight_mode = mode;
+    mark_data_dirty();
+}
+
+uint8_t get_reduced_battery_threshold()
+{
+    return get_data()->reduced_battery_threshold;
+}
+
+void set_reduced_battery_threshold(uint8_t value)
+{
+    get_data()->reduced_battery_threshold = value;
+    mark_data_dirty();
+}
+
+uint8_t get_minimal_battery_threshold()
+{
+    return get_data()->minimal_battery_threshold;
+}
+
+void set_minimal_battery_threshold(uint8_t value)
+{
+    get_data()->minimal_battery_threshold = value;
+    mark_data_dirty();
+}
+
+bool has_reminder()
+{
+    return get_data()->reminder_hour != NO_REMINDER;
+}
+
+uint8_t get_reminder_hour()
+{
+    return get_data()->reminder_hour;
+}
+
+void set_reminder_hour(uint8_t hour)
+{
+    get_data()->reminder_hour = hour;
+    mark_data_dirty();
+}
+
+uint8_t get_exercise_index()
+{
+    return get_data()->exercise_index;
+}
+
+void set_exercise_index(uint8_t value)
 {
     Data* data = get_data();
-    data->auto_kill = !data->auto_kill;
-    save_data();
+    if(data->exercise_index != value)
+    {
+        data->exercise_index = value;
+        mark_data_dirty();
+    }
 }
 
 uint8_t get_current_quad_time()
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 
 #include "data.h"
+#include "backlight.h"
 
 GColor8 get_background_color();
 GColor8 get_foreground_color();
@@ -16,14 +17,30 @@ void set_long_quad_time(uint8_t value);
 void set_short_quad_time(uint8_t value);
 
 bool is_dark_theme();
-void toggle_theme();
+void set_dark_theme(bool dark);
 
 bool has_any_data();
 void save_data();
+void flush_data();
 
 bool use_auto_start();
-void toggle_auto_start();
+void set_auto_start(bool value);
 bool use_auto_kill();
-void toggle_auto_kill();
+void set_auto_kill(bool value);
+bool use_haptic_only();
+void set_haptic_only(bool value);
+BacklightMode get_backlight_mode();
+void set_backlight_mode(BacklightMode mode);
+uint8_t get_reduced_battery_threshold();
+void set_reduced_battery_threshold(uint8_t value);
+uint8_t get_minimal_battery_threshold();
+void set_minimal_battery_threshold(uint8_t value);
+bool has_reminder();
+// NO_REMINDER when there is none
+uint8_t get_reminder_hour();
+void set_reminder_hour(uint8_t hour);
+
+uint8_t get_exercise_index();
+void set_exercise_index(uint8_t value);
 
 uint8_t get_current_quad_time();
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "phone_link.h"
+
+#include "settings_sync.h"
+#include "exercise_upload.h"
+
+#define LOG_MODULE_LEVEL LOG_LEVEL_PHONE_LINK
+#include "log.h"
+
+#define INBOX_SIZE (SETTINGS_MESSAGE_SIZE > UPLOAD_MESSAGE_SIZE ? SETTINGS_MESSAGE_SIZE : UPLOAD_MESSAGE_SIZE)
+// Upload acks are only two tuples
+#define OUTBOX_SIZE (SETTINGS_MESSAGE_SIZE)
+
+static PhoneLinkHandlers m_handlers;
+static bool m_settings_pending = false;
+static bool m_sending = false;
+
+int32_t get_tuple_int(const Tuple* tuple)
+{
+    bool is_signed = tuple->type == TUPLE_INT;
+    switch(tuple->length)
+    {
+        case 1:
+            return is_signed ? tuple->value->int8 : tuple->value->uint8;
+        case 2:
+            return is_signed ? tuple->value->int16 : tuple->value->uint16;
+        default:
+            return is_signed ? tuple->value->int32 : (int32_t)tuple->value->uint32;
+    }
+}
+
+// The outbox holds one message at a time, an upload ack goes before the
+// settings so the phone's upload window keeps moving
+static void send_next_message()
+{
+    bool send_ack = has_upload_ack();
+    if(m_sending || (!send_ack && !m_settings_pending))
+    {
+        return;
+    }
+
+    DictionaryIterator* iterator;
+    AppMessageResult result = app_message_outbox_begin(&iterator);
+    if(result != APP_MSG_OK)
+    {
+        LOG_WARNING("Could not begin a message: %d", (int)result);
+        return;
+    }
+    if(send_ack)
+    {
+        write_upload_ack(iterator);
+    } else {
+        write_settings_message(iterator);
+        m_settings_pending = false;
+    }
+    m_sending = app_message_outbox_send() == APP_MSG_OK;
+}
+
+static void handle_outbox_sent(DictionaryIterator* iterator, void* context)
+{
+    m_sending = false;
+    send_next_message();
+}
+
+static void handle_outbox_failed(DictionaryIterator* iterator, AppMessageResult reason, void* context)
+{
+    // A lost ack is not sent again, the phone asks anew when it stops hearing back
+    LOG_WARNING("Could not send a message: %d", (int)reason);
+    m_sending = false;
+    send_next_message();
+}
+
+static void handle_inbox_received(DictionaryIterator* iterator, void* context)
+{
+    switch(handle_upload_message(iterator))
+    {
+        case UploadEventNONE:
+            if(apply_settings_message(iterator) && m_handlers.settings_received != NULL)
+            {
+                m_handlers.settings_received();
+            }
+            break;
+        case UploadEventExerciseChanged:
+            if(m_handlers.custom_exercise_changed != NULL)
+            {
+                m_handlers.custom_exercise_changed();
+            }
+            break;
+        case UploadEventProgress:
+            break;
+    }
+    send_next_message();
+}
+
+static void handle_inbox_dropped(AppMessageResult reason, void* context)
+{
+    LOG_WARNING("Dropped a message: %d", (int)reason);
+}
+
+void open_phone_link(PhoneLinkHandlers handlers)
+{
+    m_handlers = handlers;
+    app_message_register_inbox_received(handle_inbox_received);
+    app_message_register_inbox_dropped(handle_inbox_dropped);
+    app_message_register_outbox_sent(handle_outbox_sent);
+    app_message_register_outbox_failed(handle_outbox_failed);
+    AppMessageResult result = app_message_open(INBOX_SIZE, OUTBOX_SIZE);
+    if(result != APP_MSG_OK)
+    {
+        LOG_ERROR("Could not open AppMessage: %d", (int)result);
+        return;
+    }
+    m_settings_pending = true;
+    send_next_message();
+}
+
+void close_phone_link()
+{
+    app_message_deregister_callbacks();
+    m_handlers = (PhoneLinkHandlers) { 0 };
+    m_settings_pending = false;
+    m_sending = false;
+}
\ No newline at end of file
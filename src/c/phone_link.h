@@ -0,0 +1,21 @@
+#pragma once
+
+#include <pebble.h>
+
+typedef void (*SettingsReceivedHandler)();
+typedef void (*CustomExerciseChangedHandler)();
+
+typedef struct {
+    // Called after settings from the phone have been applied and saved
+    SettingsReceivedHandler settings_received;
+    // Called when an upload replaces or finishes the custom exercise
+    CustomExerciseChangedHandler custom_exercise_changed;
+} PhoneLinkHandlers;
+
+// Opens AppMessage for settings sync and custom exercise uploads and
+// sends the current settings, messages from the phone go to whichever of
+// the two they belong to
+void open_phone_link(PhoneLinkHandlers handlers);
+void close_phone_link();
+
+int32_t get_tuple_int(const Tuple* tuple);
\ No newline at end of file
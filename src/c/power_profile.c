@@ -0,0 +1,66 @@
+#include "power_profile.h"
+
+#include "persistance.h"
+
+static const PowerProfileSettings PROFILES[] =
+{
+    [PowerProfileFull] = { .refresh_interval_ms = 1000 / 20, .radius_steps = 0, .animate_holds = true },
+    [PowerProfileReduced] = { .refresh_interval_ms = 1000 / 8, .radius_steps = 0, .animate_holds = false },
+    [PowerProfileMinimal] = { .refresh_interval_ms = 1000, .radius_steps = 4, .animate_holds = false },
+};
+
+static PowerProfile m_profile = PowerProfileFull;
+static PowerProfileChangedHandler m_handler = NULL;
+
+static PowerProfile get_profile_for(BatteryChargeState charge)
+{
+    if(charge.is_charging || charge.is_plugged)
+    {
+        return PowerProfileFull;
+    }
+    if(charge.charge_percent < get_minimal_battery_threshold())
+    {
+        return PowerProfileMinimal;
+    }
+    if(charge.charge_percent < get_reduced_battery_threshold())
+    {
+        return PowerProfileReduced;
+    }
+    return PowerProfileFull;
+}
+
+static void handle_battery_state(BatteryChargeState charge)
+{
+    PowerProfile profile = get_profile_for(charge);
+    if(profile != m_profile)
+    {
+        m_profile = profile;
+        if(m_handler != NULL)
+        {
+            m_handler(profile);
+        }
+    }
+}
+
+void start_power_profile(PowerProfileChangedHandler handler)
+{
+    m_handler = handler;
+    m_profile = get_profile_for(battery_state_service_peek());
+    battery_state_service_subscribe(handle_battery_state);
+}
+
+void stop_power_profile()
+{
+    battery_state_service_unsubscribe();
+    m_handler = NULL;
+}
+
+PowerProfile get_power_profile()
+{
+    return m_profile;
+}
+
+const PowerProfileSettings* get_power_profile_settings()
+{
+    return &PROFILES[m_profile];
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <pebble.h>
+
+typedef enum {
+    PowerProfileFull,
+    PowerProfileReduced,
+    PowerProfileMinimal,
+} PowerProfile;
+
+typedef struct {
+    uint16_t refresh_interval_ms;
+    // Number of distinct radii a breath is drawn with, 0 for every pixel
+    uint8_t radius_steps;
+    bool animate_holds;
+} PowerProfileSettings;
+
+typedef void (*PowerProfileChangedHandler)(PowerProfile profile);
+
+// Picks the profile from the battery state and follows it until stopped,
+// handler is called whenever the profile changes
+void start_power_profile(PowerProfileChangedHandler handler);
+void stop_power_profile();
+
+PowerProfile get_power_profile();
+const PowerProfileSettings* get_power_profile_settings();
\ No newline at end of file
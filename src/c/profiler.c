@@ -0,0 +1,195 @@
+#include "profiler.h"
+
+#ifdef BREATH_PROFILING
+
+#include "session_timeline.h"
+#include "persistance.h"
+#include "log.h"
+#include "heap_tracker.h"
+
+#define FPS_NOMINAL (20)
+// Fits the frame counters with every value at its widest, 10 digits each
+#define OVERLAY_TEXT_LENGTH (64)
+
+typedef struct {
+    uint64_t session_start_ms;
+    uint64_t expected_fire_ms;
+    uint64_t render_start_ms;
+    uint32_t frames_scheduled;
+    uint32_t frames_drawn;
+    uint32_t render_ms_total;
+    uint32_t render_ms_max;
+    uint32_t max_lateness_ms;
+    size_t heap_used_max;
+    size_t heap_free_min;
+} ProfileCounters;
+
+static ProfileCounters m_counters;
+static bool m_session_active = false;
+
+static uint64_t m_launch_ms = 0;
+static bool m_first_frame_pending = false;
+
+// Long press up steps through the pages and back to hidden
+typedef enum {
+    OverlayHidden,
+    OverlayFrames,
+    OverlayHeap,
+    OverlayPageCOUNT,
+} OverlayPage;
+
+static Layer* m_overlay_layer = NULL;
+static OverlayPage m_overlay_page = OverlayHidden;
+
+static void sample_heap()
+{
+    size_t used = heap_bytes_used();
+    size_t free = heap_bytes_free();
+    if(used > m_counters.heap_used_max)
+    {
+        m_counters.heap_used_max = used;
+    }
+    if(free < m_counters.heap_free_min)
+    {
+        m_counters.heap_free_min = free;
+    }
+}
+
+static uint32_t get_session_ms()
+{
+    return (uint32_t)(get_now_ms() - m_counters.session_start_ms);
+}
+
+// Delivered frames per second, in tenths
+static uint32_t get_delivered_fps_tenths()
+{
+    uint32_t session_ms = get_session_ms();
+    return session_ms > 0 ? (m_counters.frames_drawn * 10000) / session_ms : 0;
+}
+
+void profile_launch()
+{
+    m_launch_ms = get_now_ms();
+    m_first_frame_pending = true;
+}
+
+void profile_begin_session()
+{
+    memset(&m_counters, 0, sizeof(ProfileCounters));
+    m_counters.session_start_ms = get_now_ms();
+    m_counters.heap_free_min = (size_t)-1;
+    m_session_active = true;
+    sample_heap();
+}
+
+void profile_end_session()
+{
+    if(!m_session_active)
+    {
+        return;
+    }
+    m_session_active = false;
+    uint32_t fps_tenths = get_delivered_fps_tenths();
+    LOG_INFO("profile: %lus fps %lu.%lu/%d frames %lu/%lu render avg %lums max %lums late max %lums heap used max %u free min %u",
+        (unsigned long)(get_session_ms() / 1000),
+        (unsigned long)(fps_tenths / 10), (unsigned long)(fps_tenths % 10), FPS_NOMINAL,
+        (unsigned long)m_counters.frames_drawn, (unsigned long)m_counters.frames_scheduled,
+        (unsigned long)(m_counters.frames_drawn > 0 ? m_counters.render_ms_total / m_counters.frames_drawn : 0),
+        (unsigned long)m_counters.render_ms_max,
+        (unsigned long)m_counters.max_lateness_ms,
+        (unsigned)m_counters.heap_used_max, (unsigned)m_counters.heap_free_min);
+}
+
+void profile_frame_scheduled(uint32_t delay_ms)
+{
+    m_counters.frames_scheduled++;
+    m_counters.expected_fire_ms = get_now_ms() + delay_ms;
+}
+
+void profile_frame_timer_fired()
+{
+    uint64_t now = get_now_ms();
+    if(now > m_counters.expected_fire_ms)
+    {
+        uint32_t lateness_ms = (uint32_t)(now - m_counters.expected_fire_ms);
+        if(lateness_ms > m_counters.max_lateness_ms)
+        {
+            m_counters.max_lateness_ms = lateness_ms;
+        }
+    }
+}
+
+void profile_begin_render()
+{
+    m_counters.render_start_ms = get_now_ms();
+}
+
+void profile_end_render()
+{
+    uint32_t render_ms = (uint32_t)(get_now_ms() - m_counters.render_start_ms);
+    m_counters.frames_drawn++;
+    m_counters.render_ms_total += render_ms;
+    if(render_ms > m_counters.render_ms_max)
+    {
+        m_counters.render_ms_max = render_ms;
+    }
+    sample_heap();
+    if(m_first_frame_pending && m_session_active)
+    {
+        m_first_frame_pending = false;
+        LOG_INFO("profile: first session frame %lums after launch", (unsigned long)(get_now_ms() - m_launch_ms));
+    }
+}
+
+static void update_overlay_layer(Layer* layer, GContext* ctx)
+{
+    static char text[OVERLAY_TEXT_LENGTH];
+
+    GRect bounds = layer_get_bounds(layer);
+    if(m_overlay_page == OverlayHidden)
+    {
+        // The main layer does not repaint its background every frame, so a
+        // hidden overlay has to clear what it drew itself
+        graphics_context_set_fill_color(ctx, get_background_color());
+        graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+        return;
+    }
+
+    if(m_overlay_page == OverlayHeap)
+    {
+        format_heap_report(text, sizeof(text));
+    } else {
+        uint32_t fps_tenths = get_delivered_fps_tenths();
+        snprintf(text, sizeof(text), "%u.%ufps %ums +%ums %uB",
+            (unsigned)(fps_tenths / 10), (unsigned)(fps_tenths % 10),
+            (unsigned)m_counters.render_ms_max,
+            (unsigned)m_counters.max_lateness_ms,
+            (unsigned)m_counters.heap_used_max);
+    }
+
+    graphics_context_set_fill_color(ctx, GColorBlack);
+    graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+    graphics_context_set_text_color(ctx, GColorWhite);
+    graphics_draw_text(ctx, text, fonts_get_system_font(FONT_KEY_GOTHIC_14), bounds, GTextOverflowModeFill, GTextAlignmentLeft, NULL);
+}
+
+void setup_profile_overlay(Layer* parent, GRect frame)
+{
+    m_overlay_layer = TRACK_CREATE(HeapTagLayers, layer_create(frame));
+    layer_set_update_proc(m_overlay_layer, update_overlay_layer);
+    layer_add_child(parent, m_overlay_layer);
+}
+
+void tear_down_profile_overlay()
+{
+    TRACK_DESTROY(layer_destroy, m_overlay_layer);
+    m_overlay_layer = NULL;
+}
+
+void toggle_profile_overlay(ClickRecognizerRef recognizer, void* context)
+{
+    m_overlay_page = (m_overlay_page + 1) % OverlayPageCOUNT;
+    layer_mark_dirty(m_overlay_layer);
+}
+
+#endif
\ No newline at end of file
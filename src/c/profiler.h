@@ -0,0 +1,46 @@
+#pragma once
+
+#include <pebble.h>
+
+// Per session frame profiling, only built when BREATH_PROFILING is defined
+// (set BREATH_PROFILING=1 in the environment before pebble build). Call
+// sites use the PROFILE_ macros so release builds contain none of it.
+
+#ifdef BREATH_PROFILING
+
+void profile_launch();
+void profile_begin_session();
+void profile_end_session();
+void profile_frame_scheduled(uint32_t delay_ms);
+void profile_frame_timer_fired();
+void profile_begin_render();
+void profile_end_render();
+void setup_profile_overlay(Layer* parent, GRect frame);
+void tear_down_profile_overlay();
+void toggle_profile_overlay(ClickRecognizerRef recognizer, void* context);
+
+#define PROFILE_LAUNCH() profile_launch()
+#define PROFILE_BEGIN_SESSION() profile_begin_session()
+#define PROFILE_END_SESSION() profile_end_session()
+#define PROFILE_FRAME_SCHEDULED(delay_ms) profile_frame_scheduled(delay_ms)
+#define PROFILE_FRAME_TIMER_FIRED() profile_frame_timer_fired()
+#define PROFILE_BEGIN_RENDER() profile_begin_render()
+#define PROFILE_END_RENDER() profile_end_render()
+#define PROFILE_SETUP_OVERLAY(parent, frame) setup_profile_overlay(parent, frame)
+#define PROFILE_TEAR_DOWN_OVERLAY() tear_down_profile_overlay()
+#define PROFILE_SUBSCRIBE_OVERLAY_TOGGLE(button_id) window_long_click_subscribe(button_id, 0, toggle_profile_overlay, NULL)
+
+#else
+
+#define PROFILE_LAUNCH()
+#define PROFILE_BEGIN_SESSION()
+#define PROFILE_END_SESSION()
+#define PROFILE_FRAME_SCHEDULED(delay_ms)
+#define PROFILE_FRAME_TIMER_FIRED()
+#define PROFILE_BEGIN_RENDER()
+#define PROFILE_END_RENDER()
+#define PROFILE_SETUP_OVERLAY(parent, frame)
+#define PROFILE_TEAR_DOWN_OVERLAY()
+#define PROFILE_SUBSCRIBE_OVERLAY_TOGGLE(button_id)
+
+#endif
\ No newline at end of file
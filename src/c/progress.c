@@ -0,0 +1,80 @@
+#include "progress.h"
+
+uint32_t get_progress(uint32_t elapsed_ms, uint32_t duration_ms)
+{
+    if(duration_ms == 0 || elapsed_ms >= duration_ms)
+    {
+        return PROGRESS_ONE;
+    }
+    // Scale both down until elapsed << PROGRESS_SHIFT fits in 32 bits,
+    // keeps the division in a single hardware udiv
+    while(duration_ms >= PROGRESS_ONE)
+    {
+        duration_ms >>= 1;
+        elapsed_ms >>= 1;
+    }
+    return (elapsed_ms << PROGRESS_SHIFT) / duration_ms;
+}
+
+uint32_t invert_progress(uint32_t progress)
+{
+    return progress >= PROGRESS_ONE ? 0 : PROGRESS_ONE - progress;
+}
+
+uint8_t progress_to_percent(uint32_t progress)
+{
+    return (progress * 100) >> PROGRESS_SHIFT;
+}
+
+uint16_t interpolate_radius(uint16_t from, uint16_t to, uint32_t progress)
+{
+    if(to >= from)
+    {
+        return from + (((uint32_t)(to - from) * progress) >> PROGRESS_SHIFT);
+    } else
+    {
+        return from - (((uint32_t)(from - to) * progress) >> PROGRESS_SHIFT);
+    }
+}
+
+int32_t progress_to_trigangle(uint32_t progress)
+{
+    // TRIG_MAX_ANGLE is a full turn, pre shift to keep the product in 32 bits
+    return (int32_t)((progress * (TRIG_MAX_ANGLE >> 8)) >> (PROGRESS_SHIFT - 8));
+}
+
+uint32_t get_arc_length(uint16_t radius)
+{
+    // 710 / 113 is a close integer approximation of 2 * pi
+    return ((uint32_t)radius * 710) / 113;
+}
+
+// Rounds progress down to one of steps evenly spaced values, 0 steps keeps it as is
+uint32_t quantize_progress(uint32_t progress, uint32_t steps)
+{
+    if(steps == 0)
+    {
+        return progress;
+    }
+    return ((progress * steps) >> PROGRESS_SHIFT) * PROGRESS_ONE / steps;
+}
+
+uint32_t get_ms_until_next_step(uint32_t elapsed_ms, uint32_t duration_ms, uint32_t steps)
+{
+    if(elapsed_ms >= duration_ms)
+    {
+        return 0;
+    }
+    if(steps == 0)
+    {
+        return duration_ms - elapsed_ms;
+    }
+    // First time at which the animation has moved to the next visible step
+    uint32_t next_step = (elapsed_ms * steps) / duration_ms + 1;
+    uint32_t next_step_ms = (next_step * duration_ms + steps - 1) / steps;
+    if(next_step_ms > duration_ms)
+    {
+        next_step_ms = duration_ms;
+    }
+    return next_step_ms - elapsed_ms;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <pebble.h>
+
+// Progress is a Q16 fixed point value where PROGRESS_ONE equals 100%
+#define PROGRESS_SHIFT (16)
+#define PROGRESS_ONE ((uint32_t)1 << PROGRESS_SHIFT)
+
+uint32_t get_progress(uint32_t elapsed_ms, uint32_t duration_ms);
+uint32_t invert_progress(uint32_t progress);
+uint8_t progress_to_percent(uint32_t progress);
+uint16_t interpolate_radius(uint16_t from, uint16_t to, uint32_t progress);
+int32_t progress_to_trigangle(uint32_t progress);
+uint32_t get_arc_length(uint16_t radius);
+uint32_t quantize_progress(uint32_t progress, uint32_t steps);
+uint32_t get_ms_until_next_step(uint32_t elapsed_ms, uint32_t duration_ms, uint32_t steps);
\ No newline at end of file
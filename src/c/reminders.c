@@ -0,0 +1,82 @@
+#include "reminders.h"
+
+#include "persistance.h"
+
+#define LOG_MODULE_LEVEL LOG_LEVEL_APP
+#include "log.h"
+
+static const uint32_t REMINDER_WAKEUP_KEY = 659171;
+
+#define SECONDS_PER_DAY (24 * 60 * 60)
+// Wakeups within a minute of another app's are refused, try a bit later
+#define RESCHEDULE_STEP_S (60)
+#define MAX_SCHEDULE_ATTEMPTS (5)
+
+static ReminderHandler m_handler = NULL;
+
+static time_t get_next_reminder_time(uint8_t hour)
+{
+    time_t now = time(NULL);
+    struct tm reminder = *localtime(&now);
+    reminder.tm_hour = hour;
+    reminder.tm_min = 0;
+    reminder.tm_sec = 0;
+    time_t next = mktime(&reminder);
+    return next > now ? next : next + SECONDS_PER_DAY;
+}
+
+static void cancel_reminder()
+{
+    if(persist_exists(REMINDER_WAKEUP_KEY))
+    {
+        wakeup_cancel(persist_read_int(REMINDER_WAKEUP_KEY));
+        persist_delete(REMINDER_WAKEUP_KEY);
+    }
+}
+
+void schedule_reminder()
+{
+    cancel_reminder();
+    if(!has_reminder())
+    {
+        return;
+    }
+
+    time_t next = get_next_reminder_time(get_reminder_hour());
+    WakeupId id = E_RANGE;
+    for(uint8_t attempt = 0; attempt < MAX_SCHEDULE_ATTEMPTS && id == E_RANGE; attempt++)
+    {
+        id = wakeup_schedule(next + attempt * RESCHEDULE_STEP_S, 0, true);
+    }
+    if(id < 0)
+    {
+        LOG_WARNING("Could not schedule the reminder: %d", (int)id);
+        return;
+    }
+    persist_write_int(REMINDER_WAKEUP_KEY, id);
+}
+
+void ensure_reminder_scheduled()
+{
+    bool pending = persist_exists(REMINDER_WAKEUP_KEY)
+        && wakeup_query(persist_read_int(REMINDER_WAKEUP_KEY), NULL);
+    if(has_reminder() != pending)
+    {
+        schedule_reminder();
+    }
+}
+
+static void handle_wakeup(WakeupId id, int32_t cookie)
+{
+    schedule_reminder();
+    if(m_handler != NULL)
+    {
+        m_handler();
+    }
+}
+
+void subscribe_reminders(ReminderHandler handler)
+{
+    m_handler = handler;
+    wakeup_service_subscribe(handle_wakeup);
+}
\ No newline at end of file
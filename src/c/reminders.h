@@ -0,0 +1,13 @@
+#pragma once
+
+#include <pebble.h>
+
+typedef void (*ReminderHandler)();
+
+// Schedules the daily reminder wakeup from the settings, replacing any
+// pending one
+void schedule_reminder();
+// Like schedule_reminder but leaves a pending wakeup alone
+void ensure_reminder_scheduled();
+// handler is called when a reminder fires while the app is open
+void subscribe_reminders(ReminderHandler handler);
\ No newline at end of file
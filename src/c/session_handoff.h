@@ -0,0 +1,44 @@
+#pragma once
+
+// Shared by the app and the background worker. A running session is
+// handed over through persistent storage, which both of them can read,
+// and AppWorkerMessage is used to ask the worker to hand it back.
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "exercise_program.h"
+
+#define SESSION_HANDOFF_KEY (659170)
+#define SESSION_HANDOFF_VERSION (1)
+
+typedef enum {
+    HandoffNONE,
+    HandoffRunning,
+    HandoffFinished,
+} HandoffState;
+
+typedef struct __attribute__((__packed__)) {
+    uint8_t version;
+    uint8_t state;
+    uint8_t quad_time;
+    uint8_t exercise_index;
+    uint32_t session_start_time;
+    // Session time at wall_ms, while running it keeps counting from there
+    uint32_t elapsed_ms;
+    uint64_t wall_ms;
+    ProgramInstruction program[MAX_EXERCISE_INSTRUCTIONS];
+} SessionHandoff;
+
+typedef enum {
+    WorkerMessageHandBack = 1,
+    WorkerMessageHandedBack,
+} WorkerMessageType;
+
+static inline uint32_t get_handoff_elapsed_ms(const SessionHandoff* handoff, uint64_t now_ms)
+{
+    if(handoff->state != HandoffRunning || now_ms < handoff->wall_ms)
+    {
+        return handoff->elapsed_ms;
+    }
+    return handoff->elapsed_ms + (uint32_t)(now_ms - handoff->wall_ms);
+}
\ No newline at end of file
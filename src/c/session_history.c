@@ -0,0 +1,106 @@
+#include "session_history.h"
+
+#define LOG_MODULE_LEVEL LOG_LEVEL_HISTORY
+#include "log.h"
+
+// The log is a ring of fixed size chunks, each chunk a persist key holding
+// as many packed records as fit in one value. The index key tells which
+// chunk is the head and how full it is, so an append reads and writes only
+// the head chunk and the index. When the head fills up the ring moves on
+// and the oldest chunk is overwritten.
+#define HISTORY_CHUNK_COUNT (4)
+#define RECORDS_PER_CHUNK (PERSIST_DATA_MAX_LENGTH / sizeof(SessionRecord))
+
+static const uint32_t HISTORY_INDEX_KEY = 659160;
+static const uint32_t HISTORY_FIRST_CHUNK_KEY = 659161;
+
+typedef struct __attribute__((__packed__)) {
+    uint8_t head_chunk;
+    uint8_t head_count;
+    uint8_t wrapped;
+    uint8_t reserved;
+} HistoryIndex;
+
+static HistoryIndex m_index;
+static bool m_index_loaded = false;
+
+static HistoryIndex* get_index()
+{
+    if(!m_index_loaded)
+    {
+        memset(&m_index, 0, sizeof(HistoryIndex));
+        if(persist_exists(HISTORY_INDEX_KEY))
+        {
+            persist_read_data(HISTORY_INDEX_KEY, &m_index, sizeof(HistoryIndex));
+        }
+        if(m_index.head_chunk >= HISTORY_CHUNK_COUNT || m_index.head_count > RECORDS_PER_CHUNK)
+        {
+            LOG_WARNING("Resetting corrupt session history index");
+            memset(&m_index, 0, sizeof(HistoryIndex));
+        }
+        m_index_loaded = true;
+    }
+    return &m_index;
+}
+
+static uint32_t get_chunk_key(uint8_t chunk)
+{
+    return HISTORY_FIRST_CHUNK_KEY + chunk;
+}
+
+void append_session_record(const SessionRecord* record)
+{
+    HistoryIndex* index = get_index();
+    SessionRecord chunk[RECORDS_PER_CHUNK];
+
+    if(index->head_count == RECORDS_PER_CHUNK)
+    {
+        index->head_chunk = (index->head_chunk + 1) % HISTORY_CHUNK_COUNT;
+        index->head_count = 0;
+        if(index->head_chunk == 0)
+        {
+            index->wrapped = 1;
+        }
+    }
+    if(index->head_count > 0)
+    {
+        persist_read_data(get_chunk_key(index->head_chunk), chunk, index->head_count * sizeof(SessionRecord));
+    }
+
+    chunk[index->head_count++] = *record;
+    persist_write_data(get_chunk_key(index->head_chunk), chunk, index->head_count * sizeof(SessionRecord));
+    persist_write_data(HISTORY_INDEX_KEY, index, sizeof(HistoryIndex));
+}
+
+uint16_t get_session_record_count()
+{
+    HistoryIndex* index = get_index();
+    if(index->wrapped)
+    {
+        return (HISTORY_CHUNK_COUNT - 1) * RECORDS_PER_CHUNK + index->head_count;
+    }
+    return index->head_chunk * RECORDS_PER_CHUNK + index->head_count;
+}
+
+bool read_session_record(uint16_t newest_first_index, SessionRecord* record)
+{
+    HistoryIndex* index = get_index();
+    if(newest_first_index >= get_session_record_count())
+    {
+        return false;
+    }
+
+    uint8_t chunk_number = index->head_chunk;
+    uint16_t count = index->head_count;
+    while(newest_first_index >= count)
+    {
+        newest_first_index -= count;
+        chunk_number = (chunk_number + HISTORY_CHUNK_COUNT - 1) % HISTORY_CHUNK_COUNT;
+        count = RECORDS_PER_CHUNK;
+    }
+
+    SessionRecord chunk[RECORDS_PER_CHUNK];
+    persist_read_data(get_chunk_key(chunk_number), chunk, count * sizeof(SessionRecord));
+    *record = chunk[count - 1 - newest_first_index];
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <pebble.h>
+
+#define SESSION_ABORTED (1 << 0)
+
+typedef struct __attribute__((__packed__)) {
+    uint32_t start_time;
+    uint16_t planned_s;
+    uint16_t actual_s;
+    uint8_t exercise_index;
+    uint8_t flags;
+} SessionRecord;
+
+void append_session_record(const SessionRecord* record);
+uint16_t get_session_record_count();
+bool read_session_record(uint16_t newest_first_index, SessionRecord* record);
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "session_timeline.h"
+
+// While running, elapsed time is derived from the anchor so nothing drifts
+// no matter how late timers fire. While paused it is frozen in m_paused_ms
+static uint64_t m_anchor_ms = 0;
+static uint32_t m_paused_ms = 0;
+// The latest elapsed time handed out, a clock set backwards resumes from it
+static uint32_t m_last_elapsed_ms = 0;
+static bool m_running = false;
+
+uint64_t get_now_ms()
+{
+    time_t seconds;
+    uint16_t milliseconds;
+    time_ms(&seconds, &milliseconds);
+    return (uint64_t)seconds * 1000 + milliseconds;
+}
+
+void reset_timeline()
+{
+    m_anchor_ms = 0;
+    m_paused_ms = 0;
+    m_last_elapsed_ms = 0;
+    m_running = false;
+}
+
+void resume_timeline()
+{
+    if(!m_running)
+    {
+        m_anchor_ms = get_now_ms() - m_paused_ms;
+        m_last_elapsed_ms = m_paused_ms;
+        m_running = true;
+    }
+}
+
+void pause_timeline()
+{
+    if(m_running)
+    {
+        m_paused_ms = get_timeline_elapsed_ms();
+        m_running = false;
+    }
+}
+
+// Leaves the timeline paused at elapsed_ms
+void set_timeline_elapsed_ms(uint32_t elapsed_ms)
+{
+    m_paused_ms = elapsed_ms;
+    m_running = false;
+}
+
+bool is_timeline_running()
+{
+    return m_running;
+}
+
+uint32_t get_timeline_elapsed_ms()
+{
+    if(!m_running)
+    {
+        return m_paused_ms;
+    }
+    uint64_t now = get_now_ms();
+    // Wall clock may be set backwards, never let the session rewind
+    if(now < m_anchor_ms + m_last_elapsed_ms)
+    {
+        m_anchor_ms = now - m_last_elapsed_ms;
+    }
+    m_last_elapsed_ms = (uint32_t)(now - m_anchor_ms);
+    return m_last_elapsed_ms;
+}
\ No newline at end of file
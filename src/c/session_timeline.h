@@ -0,0 +1,12 @@
+#pragma once
+
+#include <pebble.h>
+
+uint64_t get_now_ms();
+
+void reset_timeline();
+void resume_timeline();
+void pause_timeline();
+void set_timeline_elapsed_ms(uint32_t elapsed_ms);
+bool is_timeline_running();
+uint32_t get_timeline_elapsed_ms();
\ No newline at end of file
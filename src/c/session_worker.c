@@ -0,0 +1,66 @@
+#include "session_worker.h"
+
+#define LOG_MODULE_LEVEL LOG_LEVEL_SESSION_WORKER
+#include "log.h"
+
+static SessionTakenBackHandler m_taken_back_handler = NULL;
+
+void hand_off_session(const SessionHandoff* handoff)
+{
+    persist_write_data(SESSION_HANDOFF_KEY, handoff, sizeof(SessionHandoff));
+    AppWorkerResult result = app_worker_launch();
+    if(result != APP_WORKER_RESULT_SUCCESS && result != APP_WORKER_RESULT_ALREADY_RUNNING)
+    {
+        LOG_WARNING("Could not launch the session worker: %d", result);
+    }
+}
+
+static bool read_handoff(SessionHandoff* handoff)
+{
+    bool valid = persist_read_data(SESSION_HANDOFF_KEY, handoff, sizeof(SessionHandoff)) == sizeof(SessionHandoff)
+        && handoff->version == SESSION_HANDOFF_VERSION
+        && handoff->state != HandoffNONE;
+    persist_delete(SESSION_HANDOFF_KEY);
+    return valid;
+}
+
+static void finish_take_back()
+{
+    SessionHandoff handoff;
+    SessionTakenBackHandler handler = m_taken_back_handler;
+    m_taken_back_handler = NULL;
+    if(read_handoff(&handoff) && handler != NULL)
+    {
+        handler(&handoff);
+    }
+}
+
+static void handle_worker_message(uint16_t type, AppWorkerMessage* message)
+{
+    if(type == WorkerMessageHandedBack)
+    {
+        app_worker_message_unsubscribe();
+        app_worker_kill();
+        finish_take_back();
+    }
+}
+
+bool take_back_session(SessionTakenBackHandler handler)
+{
+    if(!persist_exists(SESSION_HANDOFF_KEY))
+    {
+        return false;
+    }
+    m_taken_back_handler = handler;
+    if(app_worker_is_running())
+    {
+        // The worker writes its latest state before it answers
+        app_worker_message_subscribe(handle_worker_message);
+        AppWorkerMessage message = { 0 };
+        app_worker_send_message(WorkerMessageHandBack, &message);
+    } else
+    {
+        finish_take_back();
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "session_handoff.h"
+
+typedef void (*SessionTakenBackHandler)(const SessionHandoff* handoff);
+
+// Stores the session and launches the background worker to keep guiding it
+void hand_off_session(const SessionHandoff* handoff);
+
+// Gets a handed off session back, from the worker if it still runs or
+// straight from storage if it has stopped. Returns false if there is none,
+// otherwise handler is called, possibly after this returns.
+bool take_back_session(SessionTakenBackHandler handler);
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "settings.h"
+
+#include "persistance.h"
+
+#define MAX_QUAD_BRUSH_TIME (60)
+#define MIN_QUAD_BRUSH_TIME (10)
+#define QUAD_BRUSH_TIME_STEP (5)
+
+static const char* const THEME_LABELS[] = { "Light", "Dark" };
+static const char* const BOOL_LABELS[] = { "False", "True" };
+
+// The table getters and setters all take plain values
+#define SETTING_ACCESSORS(name, getter, setter, type) \
+    static uint8_t get_##name##_setting() { return getter(); } \
+    static void set_##name##_setting(uint8_t value) { setter((type)value); }
+
+SETTING_ACCESSORS(theme, is_dark_theme, set_dark_theme, bool)
+SETTING_ACCESSORS(auto_start, use_auto_start, set_auto_start, bool)
+SETTING_ACCESSORS(auto_kill, use_auto_kill, set_auto_kill, bool)
+SETTING_ACCESSORS(haptic_only, use_haptic_only, set_haptic_only, bool)
+SETTING_ACCESSORS(backlight, get_backlight_mode, set_backlight_mode, BacklightMode)
+
+static const SettingDescriptor SETTINGS[] =
+{
+    {
+        .title = "Switch Theme", .type = SettingChoice, .min = 0, .max = 1, .step = 1,
+        .labels = THEME_LABELS, .get = get_theme_setting, .set = set_theme_setting,
+    },
+    {
+        .title = "Short time", .type = SettingNumber,
+        .min = MIN_QUAD_BRUSH_TIME, .max = MAX_QUAD_BRUSH_TIME, .step = QUAD_BRUSH_TIME_STEP,
+        .format = "%d", .get = get_short_quad_time, .set = set_short_quad_time,
+    },
+    {
+        .title = "Long time", .type = SettingNumber,
+        .min = MIN_QUAD_BRUSH_TIME, .max = MAX_QUAD_BRUSH_TIME, .step = QUAD_BRUSH_TIME_STEP,
+        .format = "%d", .get = get_long_quad_time, .set = set_long_quad_time,
+    },
+    {
+        .title = "Auto start", .type = SettingChoice, .min = 0, .max = 1, .step = 1,
+        .labels = BOOL_LABELS, .get = get_auto_start_setting, .set = set_auto_start_setting,
+    },
+    {
+        .title = "Auto kill", .type = SettingChoice, .min = 0, .max = 1, .step = 1,
+        .labels = BOOL_LABELS, .get = get_auto_kill_setting, .set = set_auto_kill_setting,
+    },
+    {
+        .title = "Haptic only", .type = SettingChoice, .min = 0, .max = 1, .step = 1,
+        .labels = BOOL_LABELS, .get = get_haptic_only_setting, .set = set_haptic_only_setting,
+    },
+    {
+        .title = "Backlight", .type = SettingChoice, .min = 0, .max = BACKLIGHT_MODE_COUNT - 1, .step = 1,
+        .labels = BACKLIGHT_MODE_NAMES, .get = get_backlight_setting, .set = set_backlight_setting,
+    },
+    {
+        .title = "Reduced power", .type = SettingNumber,
+        .min = 0, .max = MAX_BATTERY_THRESHOLD, .step = BATTERY_THRESHOLD_STEP,
+        .off_value = 0, .off_label = "Never",
+        .format = "Below %d%%", .get = get_reduced_battery_threshold, .set = set_reduced_battery_threshold,
+    },
+    {
+        .title = "Minimal power", .type = SettingNumber,
+        .min = 0, .max = MAX_BATTERY_THRESHOLD, .step = BATTERY_THRESHOLD_STEP,
+        .off_value = 0, .off_label = "Never",
+        .format = "Below %d%%", .get = get_minimal_battery_threshold, .set = set_minimal_battery_threshold,
+    },
+    {
+        .title = "Daily reminder", .type = SettingNumber, .min = 0, .max = 23, .step = 1,
+        .off_value = NO_REMINDER, .off_label = "Off",
+        .format = "%d:00", .get = get_reminder_hour, .set = set_reminder_hour,
+    },
+};
+
+uint8_t get_settings_count()
+{
+    return ARRAY_LENGTH(SETTINGS);
+}
+
+const SettingDescriptor* get_setting(uint8_t index)
+{
+    return index < ARRAY_LENGTH(SETTINGS) ? &SETTINGS[index] : NULL;
+}
+
+bool is_valid_setting_value(const SettingDescriptor* setting, int32_t value)
+{
+    if(setting->off_label != NULL && value == setting->off_value)
+    {
+        return true;
+    }
+    return value >= setting->min && value <= setting->max && (value - setting->min) % setting->step == 0;
+}
+
+void format_setting_value(const SettingDescriptor* setting, char* buffer, size_t size)
+{
+    uint8_t value = setting->get();
+    if(setting->off_label != NULL && value == setting->off_value)
+    {
+        strncpy(buffer, setting->off_label, size - 1);
+        buffer[size - 1] = '\0';
+        return;
+    }
+    if(value < setting->min || value > setting->max)
+    {
+        buffer[0] = '\0';
+        return;
+    }
+    switch(setting->type)
+    {
+        case SettingChoice:
+            strncpy(buffer, setting->labels[value - setting->min], size - 1);
+            buffer[size - 1] = '\0';
+            break;
+        case SettingNumber:
+            snprintf(buffer, size, setting->format, value);
+            break;
+    }
+}
+
+uint8_t get_next_setting_value(const SettingDescriptor* setting, uint8_t value)
+{
+    bool has_off = setting->off_label != NULL;
+    if(has_off && value == setting->off_value)
+    {
+        return setting->min == setting->off_value ? setting->min + setting->step : setting->min;
+    }
+    if(value + setting->step > setting->max)
+    {
+        return has_off ? setting->off_value : setting->min;
+    }
+    return value + setting->step;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <pebble.h>
+
+// Long enough for any formatted setting value
+#define SETTING_VALUE_LENGTH (16)
+
+typedef enum {
+    // The value indexes labels
+    SettingChoice,
+    // The value is printed with format
+    SettingNumber,
+} SettingType;
+
+// Selecting a setting steps its value from min to max and wraps around,
+// through off_value first when the setting has an off_label
+typedef struct {
+    const char* title;
+    SettingType type;
+    uint8_t min;
+    uint8_t max;
+    uint8_t step;
+    uint8_t off_value;
+    const char* off_label;
+    const char* const* labels;
+    const char* format;
+    uint8_t (*get)();
+    void (*set)(uint8_t value);
+} SettingDescriptor;
+
+// Settings are indexed by their position in the table, which is also
+// their offset from MESSAGE_KEY_Settings, so new ones are only appended
+uint8_t get_settings_count();
+const SettingDescriptor* get_setting(uint8_t index);
+
+void format_setting_value(const SettingDescriptor* setting, char* buffer, size_t size);
+uint8_t get_next_setting_value(const SettingDescriptor* setting, uint8_t value);
+bool is_valid_setting_value(const SettingDescriptor* setting, int32_t value);
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "settings_sync.h"
+
+#include "settings.h"
+#include "persistance.h"
+#include "phone_link.h"
+
+#define LOG_MODULE_LEVEL LOG_LEVEL_SETTINGS_SYNC
+#include "log.h"
+
+void write_settings_message(DictionaryIterator* iterator)
+{
+    for(uint8_t i = 0; i < get_settings_count(); i++)
+    {
+        dict_write_int32(iterator, MESSAGE_KEY_Settings + i, get_setting(i)->get());
+    }
+}
+
+bool apply_settings_message(DictionaryIterator* iterator)
+{
+    // Every changed setting only marks the data dirty, the whole batch is
+    // written with one flush at the end
+    uint8_t changed = 0;
+    for(Tuple* tuple = dict_read_first(iterator); tuple != NULL; tuple = dict_read_next(iterator))
+    {
+        uint32_t index = tuple->key - MESSAGE_KEY_Settings;
+        if(tuple->key < MESSAGE_KEY_Settings || index >= get_settings_count())
+        {
+            continue;
+        }
+        const SettingDescriptor* setting = get_setting(index);
+        int32_t value = get_tuple_int(tuple);
+        if(!is_valid_setting_value(setting, value))
+        {
+            LOG_WARNING("Ignoring %s value %d", setting->title, (int)value);
+            continue;
+        }
+        if(setting->get() != value)
+        {
+            setting->set(value);
+            changed++;
+        }
+    }
+
+    LOG_INFO("Received settings, %d changed", changed);
+    if(changed > 0)
+    {
+        flush_data();
+    }
+    return changed > 0;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <pebble.h>
+
+// Length of the Settings message key array in package.json
+#define MAX_SYNCED_SETTINGS (16)
+// Every setting is one int32 tuple behind a 7 byte tuple header, the
+// whole set fits in a single message both ways
+#define SETTINGS_TUPLE_SIZE (7 + sizeof(int32_t))
+#define SETTINGS_MESSAGE_SIZE (1 + MAX_SYNCED_SETTINGS * SETTINGS_TUPLE_SIZE)
+
+// The current settings, sent so the phone's config page starts from them
+void write_settings_message(DictionaryIterator* iterator);
+// Applies and saves the settings in a message from the phone, returns
+// whether any of them changed
+bool apply_settings_message(DictionaryIterator* iterator);
\ No newline at end of file
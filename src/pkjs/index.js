@@ -0,0 +1,336 @@
+var messageKeys = require('message_keys');
+
+var SETTINGS_STORAGE_KEY = 'settings';
+var EXERCISE_STORAGE_KEY = 'exercise';
+var UPLOAD_STORAGE_KEY = 'upload';
+// The emulator's phone stand-in replaces this with its own return URL
+var EMULATOR_RETURN_TO = '$$$RETURN_TO$$$';
+var PHONE_RETURN_TO = 'pebblejs://close#';
+
+function range(min, max, step, format) {
+    var options = [];
+    for(var value = min; value <= max; value += step) {
+        options.push([value, format(value)]);
+    }
+    return options;
+}
+
+var BOOL_OPTIONS = [[0, 'False'], [1, 'True']];
+var BATTERY_OPTIONS = [[0, 'Never']].concat(range(10, 50, 10, function(value) { return 'Below ' + value + '%'; }));
+var QUAD_TIME_OPTIONS = range(10, 60, 5, String);
+var NO_REMINDER = 255;
+
+// Same order as SETTINGS in src/c/settings.c, a setting's index is its
+// offset from the Settings message key
+var SETTINGS = [
+    { title: 'Theme', options: [[0, 'Light'], [1, 'Dark']] },
+    { title: 'Short time', options: QUAD_TIME_OPTIONS },
+    { title: 'Long time', options: QUAD_TIME_OPTIONS },
+    { title: 'Auto start', options: BOOL_OPTIONS },
+    { title: 'Auto kill', options: BOOL_OPTIONS },
+    { title: 'Haptic only', options: BOOL_OPTIONS },
+    { title: 'Backlight', options: [[0, 'Off'], [1, 'Flash'], [2, 'Dim holds'], [3, 'Always on']] },
+    { title: 'Reduced power', options: BATTERY_OPTIONS },
+    { title: 'Minimal power', options: BATTERY_OPTIONS },
+    { title: 'Daily reminder', options: [[NO_REMINDER, 'Off']].concat(range(0, 23, 1, function(hour) { return hour + ':00'; })) },
+];
+
+// Same limits as the watch, see src/c/custom_exercise.h
+var CUSTOM_EXERCISE_NAME_LENGTH = 15;
+// Instructions per data message, UPLOAD_DATA_INSTRUCTIONS on the watch
+var UPLOAD_DATA_INSTRUCTIONS = 32;
+// Data messages sent ahead of the last offset the watch acked
+var UPLOAD_WINDOW = 4;
+// Without an ack for this long the upload starts over from what the
+// watch has stored
+var UPLOAD_TIMEOUT_MS = 10000;
+var MAX_UPLOAD_RETRIES = 5;
+
+// One phase or loop per line, e.g. "repeat 10", "in 4 nose", "full 2",
+// "out 6 mouth", "end". Lengths are in beats, a quarter of the quad time.
+// Returns the program as bytes, two per instruction. It is also inlined in
+// the config page, so it can not use anything outside itself.
+function compileExercise(text) {
+    // Same encoding as ProgramInstruction in src/c/exercise_program.h
+    var MAX_CUSTOM_INSTRUCTIONS = 1024;
+    var PHASES = { 'in': 1, 'out': 2, 'full': 3, 'empty': 4 };
+    var ORIFICES = { 'mouth': 1, 'nose': 2 };
+    var OP_PHASE = 1;
+    var OP_LOOP = 2;
+    var OP_END_LOOP = 3;
+    var bytes = [];
+    var inLoop = false;
+
+    function fail(lineNumber, message) {
+        throw new Error('Line ' + lineNumber + ': ' + message);
+    }
+    function parseCount(word, lineNumber) {
+        var count = parseInt(word, 10);
+        if(!(count >= 1 && count <= 255)) {
+            fail(lineNumber, 'expected a number from 1 to 255');
+        }
+        return count;
+    }
+
+    text.split('\n').forEach(function(line, index) {
+        var words = line.replace(/#.*/, '').trim().toLowerCase().split(/\s+/);
+        var lineNumber = index + 1;
+        if(words[0] === '') {
+            return;
+        }
+        if(words[0] === 'repeat') {
+            if(inLoop) {
+                fail(lineNumber, 'repeats can not be nested');
+            }
+            bytes.push(OP_LOOP, parseCount(words[1], lineNumber));
+            inLoop = true;
+        } else if(words[0] === 'end') {
+            if(!inLoop) {
+                fail(lineNumber, 'end without repeat');
+            }
+            bytes.push(OP_END_LOOP, 0);
+            inLoop = false;
+        } else if(PHASES[words[0]] !== undefined) {
+            var orifice = ORIFICES[words[2] || 'nose'];
+            if(orifice === undefined) {
+                fail(lineNumber, 'expected mouth or nose');
+            }
+            bytes.push(OP_PHASE | (PHASES[words[0]] << 2) | (orifice << 5), parseCount(words[1], lineNumber));
+        } else {
+            fail(lineNumber, 'expected in, out, full, empty, repeat or end');
+        }
+    });
+    if(inLoop) {
+        bytes.push(OP_END_LOOP, 0);
+    }
+    if(bytes.length / 2 > MAX_CUSTOM_INSTRUCTIONS) {
+        throw new Error('Longer than ' + MAX_CUSTOM_INSTRUCTIONS + ' lines');
+    }
+    return bytes;
+}
+
+function loadStored(key, fallback) {
+    try {
+        return JSON.parse(localStorage.getItem(key)) || fallback;
+    } catch(e) {
+        return fallback;
+    }
+}
+
+function loadSettings() {
+    return loadStored(SETTINGS_STORAGE_KEY, []);
+}
+
+function saveSettings(values) {
+    localStorage.setItem(SETTINGS_STORAGE_KEY, JSON.stringify(values));
+}
+
+function escapeHtml(text) {
+    return String(text).replace(/&/g, '&amp;').replace(/</g, '&lt;').replace(/>/g, '&gt;');
+}
+
+function buildSelect(index, setting, current) {
+    var html = '<label>' + escapeHtml(setting.title) + '<select id="setting' + index + '">';
+    setting.options.forEach(function(option) {
+        var selected = option[0] === current ? ' selected' : '';
+        html += '<option value="' + option[0] + '"' + selected + '>' + escapeHtml(option[1]) + '</option>';
+    });
+    return html + '</select></label>';
+}
+
+// The page is inlined as a data URI so configuring needs no web server
+function buildConfigPage(values, exercise) {
+    var returnTo = Pebble.platform === 'pypkjs' ? EMULATOR_RETURN_TO : PHONE_RETURN_TO;
+    var html = '<!DOCTYPE html><html><head><meta charset="utf-8">' +
+        '<meta name="viewport" content="width=device-width, initial-scale=1">' +
+        '<title>Breath</title><style>' +
+        'body{font-family:sans-serif;margin:16px;background:#fff;color:#000}' +
+        'label{display:block;margin:12px 0}select,input,textarea{display:block;width:100%;font-size:16px;margin-top:4px}' +
+        'textarea{height:160px;font-family:monospace}#error{color:#c00}' +
+        'button{width:100%;font-size:18px;padding:10px;margin-top:16px}' +
+        '</style></head><body><h2>Breath</h2>';
+    SETTINGS.forEach(function(setting, index) {
+        html += buildSelect(index, setting, values[index]);
+    });
+    html += '<h3>Custom exercise</h3>' +
+        '<label>Name<input id="name" maxlength="' + CUSTOM_EXERCISE_NAME_LENGTH + '" value="' + escapeHtml(exercise.name).replace(/"/g, '&quot;') + '"></label>' +
+        '<label>Phases<textarea id="phases" placeholder="repeat 10&#10;in 4 nose&#10;full 4&#10;out 8 mouth&#10;end">' +
+        escapeHtml(exercise.text) + '</textarea></label><p id="error"></p>';
+    html += '<button onclick="save()">Save</button><script>' + compileExercise.toString() +
+        'function save(){var values=[];' +
+        'for(var i=0;i<' + SETTINGS.length + ';i++){values.push(parseInt(document.getElementById("setting"+i).value,10));}' +
+        'var exercise={name:document.getElementById("name").value,text:document.getElementById("phases").value};' +
+        'try{compileExercise(exercise.text);}catch(e){document.getElementById("error").textContent=e.message;return;}' +
+        'location.href=' + JSON.stringify(returnTo) + '+encodeURIComponent(JSON.stringify({settings:values,exercise:exercise}));}' +
+        '</script></body></html>';
+    return 'data:text/html;charset=utf-8,' + encodeURIComponent(html);
+}
+
+// All settings go in one dictionary so the watch applies them with a
+// single write
+function sendSettings(values) {
+    var dictionary = {};
+    values.forEach(function(value, index) {
+        if(index < SETTINGS.length && typeof value === 'number' && !isNaN(value)) {
+            dictionary[messageKeys.Settings + index] = value;
+        }
+    });
+    Pebble.sendAppMessage(dictionary, function() {
+        console.log('Sent settings');
+    }, function(e) {
+        console.log('Could not send settings: ' + JSON.stringify(e.error));
+    });
+}
+
+// The upload in progress, the watch acks every data message with the
+// offset of the next instruction it needs
+var upload = null;
+
+function sendUploadMessage(dictionary) {
+    Pebble.sendAppMessage(dictionary, null, function() {
+        // Everything after a lost message is sent again
+        if(upload !== null && dictionary[messageKeys.UploadOffset] !== undefined) {
+            upload.next = Math.min(upload.next, dictionary[messageKeys.UploadOffset]);
+        }
+    });
+}
+
+function armUploadTimeout() {
+    clearTimeout(upload.timer);
+    upload.timer = setTimeout(function() {
+        if(++upload.retries > MAX_UPLOAD_RETRIES) {
+            // Kept in storage, it resumes the next time the app opens
+            console.log('Custom exercise upload stalled at ' + upload.acked);
+            upload = null;
+            return;
+        }
+        beginUpload();
+    }, UPLOAD_TIMEOUT_MS);
+}
+
+function beginUpload() {
+    var dictionary = {};
+    dictionary[messageKeys.UploadId] = upload.id;
+    dictionary[messageKeys.UploadLength] = upload.bytes.length / 2;
+    dictionary[messageKeys.UploadName] = upload.name;
+    upload.next = upload.acked;
+    sendUploadMessage(dictionary);
+    armUploadTimeout();
+}
+
+function fillUploadWindow() {
+    var length = upload.bytes.length / 2;
+    var windowEnd = Math.min(length, upload.acked + UPLOAD_WINDOW * UPLOAD_DATA_INSTRUCTIONS);
+    while(upload.next < windowEnd) {
+        var end = Math.min(upload.next + UPLOAD_DATA_INSTRUCTIONS, length);
+        var dictionary = {};
+        dictionary[messageKeys.UploadId] = upload.id;
+        dictionary[messageKeys.UploadOffset] = upload.next;
+        dictionary[messageKeys.UploadData] = upload.bytes.slice(upload.next * 2, end * 2);
+        sendUploadMessage(dictionary);
+        upload.next = end;
+    }
+}
+
+function handleUploadAck(ack) {
+    if(ack < 0 || ack >= upload.bytes.length / 2) {
+        console.log(ack < 0 ? 'The watch rejected the custom exercise' : 'Uploaded the custom exercise');
+        clearTimeout(upload.timer);
+        localStorage.removeItem(UPLOAD_STORAGE_KEY);
+        upload = null;
+        return;
+    }
+    if(ack < upload.acked || (ack === upload.acked && ack < upload.next && ack !== upload.rewoundAt)) {
+        // The watch missed a message, or resumed from what it had stored,
+        // and acks the offset it still needs
+        upload.next = ack;
+        upload.rewoundAt = ack;
+    }
+    if(ack > upload.acked) {
+        // Only progress holds off the timeout, so a link that loses too
+        // much gives up after MAX_UPLOAD_RETRIES
+        upload.retries = 0;
+        armUploadTimeout();
+    }
+    upload.acked = ack;
+    fillUploadWindow();
+}
+
+function startUpload(stored) {
+    if(upload !== null) {
+        clearTimeout(upload.timer);
+    }
+    upload = { id: stored.id, name: stored.name, bytes: stored.bytes, acked: 0, next: 0, rewoundAt: -1, retries: 0, timer: null };
+    beginUpload();
+}
+
+Pebble.addEventListener('appmessage', function(e) {
+    if(e.payload[messageKeys.UploadAck] !== undefined) {
+        if(upload !== null && e.payload[messageKeys.UploadId] === upload.id) {
+            handleUploadAck(e.payload[messageKeys.UploadAck]);
+        }
+        return;
+    }
+
+    // The watch sends its current settings whenever the app opens
+    var values = loadSettings();
+    var received = false;
+    SETTINGS.forEach(function(setting, index) {
+        var value = e.payload[messageKeys.Settings + index];
+        if(value !== undefined) {
+            values[index] = value;
+            received = true;
+        }
+    });
+    if(received) {
+        saveSettings(values);
+    }
+    // The app just opened, carry on with an upload it did not finish
+    var pending = loadStored(UPLOAD_STORAGE_KEY, null);
+    if(pending !== null && upload === null) {
+        startUpload(pending);
+    }
+});
+
+function uploadExerciseIfChanged(exercise) {
+    var stored = loadStored(EXERCISE_STORAGE_KEY, { name: '', text: '' });
+    if(exercise.text.trim() === '' || (exercise.name === stored.name && exercise.text === stored.text)) {
+        return;
+    }
+    var bytes;
+    try {
+        bytes = compileExercise(exercise.text);
+    } catch(error) {
+        console.log('Not uploading the custom exercise: ' + error.message);
+        return;
+    }
+    localStorage.setItem(EXERCISE_STORAGE_KEY, JSON.stringify(exercise));
+    // A new id makes the watch replace its exercise instead of resuming
+    var pending = {
+        id: Date.now() & 0x7fffffff,
+        name: exercise.name.substring(0, CUSTOM_EXERCISE_NAME_LENGTH) || 'Custom',
+        bytes: bytes
+    };
+    localStorage.setItem(UPLOAD_STORAGE_KEY, JSON.stringify(pending));
+    startUpload(pending);
+}
+
+Pebble.addEventListener('showConfiguration', function() {
+    Pebble.openURL(buildConfigPage(loadSettings(), loadStored(EXERCISE_STORAGE_KEY, { name: '', text: '' })));
+});
+
+Pebble.addEventListener('webviewclosed', function(e) {
+    if(!e || !e.response) {
+        return;
+    }
+    var response;
+    try {
+        response = JSON.parse(decodeURIComponent(e.response));
+    } catch(error) {
+        console.log('Could not read the config page response: ' + error);
+        return;
+    }
+    saveSettings(response.settings);
+    sendSettings(response.settings);
+    uploadExerciseIfChanged(response.exercise);
+});
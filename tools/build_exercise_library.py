@@ -0,0 +1,108 @@
+#!/usr/bin/env python
+#
+# Builds resources/data/exercises.bin, the exercise library loaded by
+# src/c/exercise_library.c. Run it again after editing EXERCISES.
+#
+# Layout, all fields are single bytes:
+#   header:  'B' 'R' 'T' 'H', version, exercise count, record size, reserved
+#   records: exercise count fixed size records of
+#            name (NAME_LENGTH bytes, NUL padded)
+#            instructions (code, value) pairs, terminated by END and
+#            padded with END up to MAX_INSTRUCTIONS
+
+import os
+import struct
+
+LIBRARY_VERSION = 1
+NAME_LENGTH = 16
+MAX_INSTRUCTIONS = 24
+RECORD_SIZE = NAME_LENGTH + MAX_INSTRUCTIONS * 2
+
+# Must match ProgramOp, ActionType and Orifice in src/c/exercise_program.h
+OP_END, OP_PHASE, OP_LOOP, OP_END_LOOP = range(4)
+BREATHE_IN, BREATHE_OUT, HOLD_FULL, HOLD_EMPTY = range(1, 5)
+MOUTH, NOSE = range(1, 3)
+
+
+def phase(action_type, orifice, beats):
+    return (OP_PHASE | (action_type << 2) | (orifice << 5), beats)
+
+
+def loop(rounds):
+    return (OP_LOOP, rounds)
+
+
+END_LOOP = (OP_END_LOOP, 0)
+END = (OP_END, 0)
+
+EXERCISES = [
+    ("Classic", [
+        phase(BREATHE_IN, MOUTH, 4),
+        phase(BREATHE_OUT, MOUTH, 4),
+        phase(HOLD_EMPTY, MOUTH, 4),
+        phase(BREATHE_IN, MOUTH, 4),
+        phase(HOLD_FULL, MOUTH, 4),
+    ]),
+    ("Box", [
+        loop(4),
+        phase(BREATHE_IN, NOSE, 4),
+        phase(HOLD_FULL, NOSE, 4),
+        phase(BREATHE_OUT, MOUTH, 4),
+        phase(HOLD_EMPTY, MOUTH, 4),
+        END_LOOP,
+    ]),
+    ("4-7-8", [
+        loop(4),
+        phase(BREATHE_IN, NOSE, 4),
+        phase(HOLD_FULL, NOSE, 7),
+        phase(BREATHE_OUT, MOUTH, 8),
+        END_LOOP,
+    ]),
+    ("Coherent", [
+        loop(30),
+        phase(BREATHE_IN, NOSE, 4),
+        phase(BREATHE_OUT, NOSE, 4),
+        END_LOOP,
+    ]),
+    ("Relaxing", [
+        loop(10),
+        phase(BREATHE_IN, NOSE, 4),
+        phase(BREATHE_OUT, MOUTH, 8),
+        END_LOOP,
+    ]),
+    ("Triangle", [
+        loop(8),
+        phase(BREATHE_IN, NOSE, 4),
+        phase(HOLD_FULL, NOSE, 4),
+        phase(BREATHE_OUT, NOSE, 4),
+        END_LOOP,
+    ]),
+]
+
+
+def build_record(name, instructions):
+    encoded_name = name.encode('ascii')
+    if len(encoded_name) >= NAME_LENGTH:
+        raise ValueError("Exercise name too long: " + name)
+    if len(instructions) >= MAX_INSTRUCTIONS:
+        raise ValueError("Too many instructions in " + name)
+
+    record = encoded_name.ljust(NAME_LENGTH, b'\0')
+    padding = [END] * (MAX_INSTRUCTIONS - len(instructions))
+    for code, value in instructions + padding:
+        record += struct.pack('BB', code, value)
+    return record
+
+
+def build_library():
+    library = b'BRTH' + struct.pack('BBBB', LIBRARY_VERSION, len(EXERCISES), RECORD_SIZE, 0)
+    for name, instructions in EXERCISES:
+        library += build_record(name, instructions)
+    return library
+
+
+if __name__ == '__main__':
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    path = os.path.join(root, 'resources', 'data', 'exercises.bin')
+    with open(path, 'wb') as library_file:
+        library_file.write(build_library())
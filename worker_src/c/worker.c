@@ -0,0 +1,173 @@
+#include <pebble_worker.h>
+
+#include "session_handoff.h"
+#include "custom_exercise.h"
+#include "haptic_segments.h"
+
+// Keeps guiding a session with vibes after the app has been closed. The
+// worker has no graphics and a few KB of heap, so it only keeps the
+// handoff record, the program cursor and one timer, plus the chunk cache
+// when it streams the custom exercise.
+
+static const VibePattern HAPTIC_PATTERNS[] =
+{
+    [BreatheIn] = VIBE_PATTERN(BREATHE_IN_SEGMENTS),
+    [BreatheOut] = VIBE_PATTERN(BREATHE_OUT_SEGMENTS),
+    [HoldFullBreath] = VIBE_PATTERN(HOLD_FULL_BREATH_SEGMENTS),
+    [HoldEmptyBreath] = VIBE_PATTERN(HOLD_EMPTY_BREATH_SEGMENTS),
+};
+static const VibePattern SESSION_END_PATTERN = VIBE_PATTERN(SESSION_END_SEGMENTS);
+// Long enough for the end pattern to play before the worker exits
+#define EXIT_DELAY_MS (1000)
+
+static SessionHandoff m_handoff;
+static ProgramCursor m_program;
+static Action m_action;
+// Session time at which m_action ends
+static uint32_t m_action_end_ms;
+static AppTimer* m_timer = NULL;
+static bool m_active = false;
+
+static uint64_t get_now_ms()
+{
+    time_t seconds;
+    uint16_t milliseconds;
+    time_ms(&seconds, &milliseconds);
+    return (uint64_t)seconds * 1000 + milliseconds;
+}
+
+static void save_handoff(HandoffState state)
+{
+    uint64_t now = get_now_ms();
+    m_handoff.elapsed_ms = get_handoff_elapsed_ms(&m_handoff, now);
+    m_handoff.wall_ms = now;
+    m_handoff.state = state;
+    persist_write_data(SESSION_HANDOFF_KEY, &m_handoff, sizeof(SessionHandoff));
+}
+
+static void vibrate_action_start(ActionType type)
+{
+    if(type < sizeof(HAPTIC_PATTERNS) / sizeof(HAPTIC_PATTERNS[0]) && HAPTIC_PATTERNS[type].durations != NULL)
+    {
+        vibes_enqueue_custom_pattern(HAPTIC_PATTERNS[type]);
+    }
+}
+
+static void exit_worker(void* data)
+{
+    // The finished session waits in storage for the app to record it
+    m_timer = NULL;
+    app_worker_kill();
+}
+
+static void finish_session()
+{
+    vibes_enqueue_custom_pattern(SESSION_END_PATTERN);
+    save_handoff(HandoffFinished);
+    m_active = false;
+    m_timer = app_timer_register(EXIT_DELAY_MS, exit_worker, NULL);
+}
+
+// Moves to the action the session is in, returns false if it is over
+static bool advance_actions(uint32_t elapsed_ms, bool notify)
+{
+    bool action_changed = false;
+    while(elapsed_ms >= m_action_end_ms)
+    {
+        if(!next_program_action(&m_program, &m_action))
+        {
+            return false;
+        }
+        m_action_end_ms += m_action.duration_ms;
+        action_changed = true;
+    }
+    if(action_changed && notify)
+    {
+        vibrate_action_start(m_action.type);
+    }
+    return true;
+}
+
+static void handle_phase_timer(void* data)
+{
+    m_timer = NULL;
+    uint32_t elapsed_ms = get_handoff_elapsed_ms(&m_handoff, get_now_ms());
+    if(!advance_actions(elapsed_ms, true))
+    {
+        finish_session();
+        return;
+    }
+    m_timer = app_timer_register(m_action_end_ms - elapsed_ms, handle_phase_timer, NULL);
+}
+
+static void take_over_session()
+{
+    if(persist_read_data(SESSION_HANDOFF_KEY, &m_handoff, sizeof(SessionHandoff)) != sizeof(SessionHandoff)
+        || m_handoff.version != SESSION_HANDOFF_VERSION
+        || m_handoff.state != HandoffRunning)
+    {
+        // Nothing to guide
+        app_worker_kill();
+        return;
+    }
+
+    if(m_handoff.exercise_index == CUSTOM_EXERCISE_INDEX)
+    {
+        start_custom_program(&m_program, m_handoff.quad_time);
+    } else {
+        start_program(&m_program, m_handoff.program, m_handoff.quad_time);
+    }
+    m_action_end_ms = 0;
+    m_active = true;
+    // The app already gave the cue for the action it was in
+    uint32_t elapsed_ms = get_handoff_elapsed_ms(&m_handoff, get_now_ms());
+    if(!advance_actions(elapsed_ms, false))
+    {
+        finish_session();
+        return;
+    }
+    m_timer = app_timer_register(m_action_end_ms - elapsed_ms, handle_phase_timer, NULL);
+}
+
+static void hand_back_session()
+{
+    if(m_timer != NULL)
+    {
+        app_timer_cancel(m_timer);
+        m_timer = NULL;
+    }
+    if(m_active)
+    {
+        save_handoff(HandoffRunning);
+        m_active = false;
+    }
+}
+
+static void handle_app_message(uint16_t type, AppWorkerMessage* message)
+{
+    if(type == WorkerMessageHandBack)
+    {
+        hand_back_session();
+        AppWorkerMessage reply = { 0 };
+        app_worker_send_message(WorkerMessageHandedBack, &reply);
+    }
+}
+
+static void init()
+{
+    app_worker_message_subscribe(handle_app_message);
+    take_over_session();
+}
+
+static void deinit()
+{
+    hand_back_session();
+    app_worker_message_unsubscribe();
+}
+
+int main()
+{
+    init();
+    worker_event_loop();
+    deinit();
+}
\ No newline at end of file